@@ -60,19 +60,15 @@ bool UCreatureAnimationAssetFactory::ImportSourceFile(UCreatureAnimationAsset *f
 
 #ifdef CREATURE_USE_COMPRESS_JSON
 	// Run compression routine
-	std::string saveString(TCHAR_TO_UTF8(*readString));
+	FTCHARToUTF8 saveString(*readString);
 
 	forAsset->CreatureZipBinary.Reset();
 	FArchiveSaveCompressedProxy Compressor =
 		FArchiveSaveCompressedProxy(forAsset->CreatureZipBinary, ECompressionFlags::COMPRESS_ZLIB);
 	TArray<uint8> writeData;
-	writeData.SetNumUninitialized(saveString.length() + 1);
-	for (size_t i = 0; i < saveString.length(); i++)
-	{
-		writeData[i] = saveString.c_str()[i];
-	}
-
-	writeData[writeData.Num() - 1] = '\0';
+	writeData.Reserve(saveString.Length() + 1);
+	writeData.Append((const uint8 *)saveString.Get(), saveString.Length());
+	writeData.Add('\0');
 
 	Compressor << writeData;
 	Compressor.Flush();
@@ -25,7 +25,6 @@ namespace UnrealBuildTool.Rules
         public bool LoadCreatureLib(ReadOnlyTargetRules Target)
         {
             PublicDefinitions.Add("GLM_FORCE_RADIANS");
-            PublicDefinitions.Add("CREATURE_NO_USE_ZIP");
             PublicDefinitions.Add("CREATURE_NO_USE_EXCEPTIONS");
             PublicDefinitions.Add("CREATURE_MULTICORE");
             PublicIncludePaths.Add(Path.Combine(ThirdPartyPath, "Includes"));
@@ -44,6 +43,9 @@ namespace UnrealBuildTool.Rules
 
             PrivateDependencyModuleNames.AddRange(new string[] { "RHI", "RenderCore", "Json", "JsonUtilities" });
 
+            // zipped json exports are inflated with the engine's zlib
+            AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
             LoadCreatureLib(Target);
         }
     }
@@ -5,6 +5,8 @@
 #include "Serialization/ArchiveSaveCompressedProxy.h"
 #include "Serialization/ArchiveLoadCompressedProxy.h"
 #include "Serialization/BufferArchive.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 #if WITH_EDITORONLY_DATA
 FName UCreatureAnimationAsset::UpdateAndGetCreatureFilename()
@@ -36,6 +38,8 @@ UCreatureAnimationAsset::UseCompressedData() const
 void UCreatureAnimationAsset::forceRefreshJSONData()
 {
 	CreatureFileJSonData.Empty();
+	CreatureCore::FreeBinaryDataPackets(&CreatureCompiledBinary);
+	CreatureCompiledBinary.Empty();
 	CreatureCore::FreeDataPacket(GetCreatureFilename());
 
 #if WITH_EDITORONLY_DATA
@@ -48,10 +52,8 @@ FString& UCreatureAnimationAsset::GetJsonString()
 	// Decide if we should decompress or return the raw uncompressed string
 	if(!UseCompressedData())
 	{
-		if (CreatureFileJSonData.IsEmpty())
-		{
-			CreatureFileJSonData = CreatureRawJSONString;
-		}
+		// No need for a second copy of the raw string
+		return CreatureRawJSONString;
 	}
 	else {
 		// Decompress only when needed
@@ -75,6 +77,16 @@ FString& UCreatureAnimationAsset::GetJsonString()
 	return CreatureFileJSonData;
 }
 
+const TArray<uint8>* UCreatureAnimationAsset::GetCompressedJson() const
+{
+	return UseCompressedData() ? &CreatureZipBinary : nullptr;
+}
+
+const TArray<uint8>* UCreatureAnimationAsset::GetCompiledBinary() const
+{
+	return (CreatureCompiledBinary.Num() > 0) ? &CreatureCompiledBinary : nullptr;
+}
+
 void UCreatureAnimationAsset::SetNewJsonString(FString & str_in)
 {
 	CreatureRawJSONString = str_in;
@@ -129,32 +141,85 @@ void UCreatureAnimationAsset::LoadPointCacheForClip(const FName &animName, class
 
 		check(forCore->GetCreatureManager()->GetCreature());
 		int32 arraySize = forCore->GetCreatureManager()->GetCreature()->GetTotalNumPoints() * 3;
-		auto &pts = anim->getCachePts();
-		int32 sourcePtIdx = 0;
-		ensure(cacheForAnim->m_numArrays * arraySize == cacheForAnim->m_points.Num());
-		for (int32 i = 0; i < cacheForAnim->m_numArrays; i++)
+
+		if (cacheForAnim->m_compressedPoints.Num() > 0)
 		{
-			auto new_pts = new glm::float32[arraySize];
-			for (int32 j = 0; j < arraySize; j++)
+			FMemoryReader reader(cacheForAnim->m_compressedPoints);
+			CreatureModule::CreatureCompressedPointCache& compressed_cache = anim->getCompressedCachePts();
+			compressed_cache.serialize(reader);
+
+			// A cache gathered for a different version of the character must not be decoded
+			if (!ensure(!reader.IsError() && compressed_cache.isValid(arraySize)))
 			{
-				new_pts[j] = cacheForAnim->m_points[sourcePtIdx++];
+				compressed_cache.clear();
+			}
+		}
+		else
+		{
+			if (!ensure(cacheForAnim->m_numArrays * arraySize == cacheForAnim->m_points.Num()))
+			{
+				return;
+			}
+
+			// The editor regathers the data cache on save, so only read it in place when that can not happen
+			if (!GIsEditor)
+			{
+				anim->bindCachePts(cacheForAnim->m_points.GetData(), cacheForAnim->m_numArrays, arraySize);
+			}
+			else
+			{
+				auto &pts = anim->getCachePts();
+				int32 sourcePtIdx = 0;
+				for (int32 i = 0; i < cacheForAnim->m_numArrays; i++)
+				{
+					auto new_pts = new glm::float32[arraySize];
+					for (int32 j = 0; j < arraySize; j++)
+					{
+						new_pts[j] = cacheForAnim->m_points[sourcePtIdx++];
+					}
+					pts.Add(new_pts);
+				}
 			}
-			pts.Add(new_pts);
 		}
+
+		anim->setCacheSampleFrames(cacheForAnim->m_sampleFrames);
 	}
 }
 
+void UCreatureAnimationAsset::BeginDestroy()
+{
+	// The shared animations outlive this asset, they must not keep reading the point caches bound in place
+	for (const FCreatureAnimationDataCache & cache : m_dataCache)
+	{
+		if (cache.m_points.Num() > 0)
+		{
+			CreatureCore::UnbindPointCache(cache.m_points.GetData());
+		}
+	}
+
+	// Packets loaded from the compiled binary read it in place
+	if (CreatureCompiledBinary.Num() > 0)
+	{
+		CreatureCore::FreeBinaryDataPackets(&CreatureCompiledBinary);
+	}
+
+	Super::BeginDestroy();
+}
+
 void UCreatureAnimationAsset::Serialize(FArchive& Ar)
 {
 	if (Ar.IsSaving() && !Ar.IsCooking())
 	{
-		// when saving non-cooked asset, don't include the datacache as it's huge
+		// when saving non-cooked asset, don't include the datacache or compiled binary as they're huge
 		TArray<FCreatureAnimationDataCache> cacheCopy = m_dataCache;
 		m_dataCache.Reset();
+		TArray<uint8> binaryCopy = MoveTemp(CreatureCompiledBinary);
+		CreatureCompiledBinary.Reset();
 
 		Super::Serialize(Ar);
 
 		m_dataCache = cacheCopy;
+		CreatureCompiledBinary = MoveTemp(binaryCopy);
 	}
 	else
 	{
@@ -222,15 +287,25 @@ void UCreatureAnimationAsset::GatherAnimationData()
 	
 	// load the JSON data into creature so we can extract the animation names and generate the point caches for the anims
 	CreatureCore creature_core;
-	creature_core.pJsonData = &GetJsonString();
+	creature_core.pZipJsonData = GetCompressedJson();
+	if (creature_core.pZipJsonData == nullptr)
+	{
+		creature_core.pJsonData = &GetJsonString();
+	}
 	creature_core.creature_filename = creature_filename;
 	creature_core.InitCreatureRender();
 
+	// compile the loaded data into the binary format for fast runtime loading
+	CreatureCore::FreeBinaryDataPackets(&CreatureCompiledBinary);
+	CreatureCompiledBinary.Reset();
+	CreatureCore::CompileDataPacket(creature_filename, CreatureCompiledBinary, m_bonesCompressionTolerance, m_displacementsCompressionTolerance);
+
 	auto all_animation_names = creature_core.GetCreatureManager()->GetCreature()->GetAnimationNames();
 
 	int32 arraySize = creature_core.GetCreatureManager()->GetCreature()->GetTotalNumPoints() * 3;
 
 	m_dataCache.Reset(all_animation_names.Num());
+	creature_core.GetCreatureManager()->SetCompressPointCache(m_compressPointsCache);
 
 	for (auto& cur_name : all_animation_names)
 	{
@@ -244,8 +319,15 @@ void UCreatureAnimationAsset::GatherAnimationData()
 			if (m_pointsCacheApproximationLevel >= 0)
 			{
 				creature_core.GetCreatureManager()->ClearPointCache(cur_name);
-				creature_core.GetCreatureManager()->MakePointCache(cur_name, m_pointsCacheApproximationLevel);
-				if (anim->hasCachePts())
+				creature_core.GetCreatureManager()->MakePointCache(cur_name, m_pointsCacheApproximationLevel, m_pointsCacheMaxError);
+				animDataCache.m_sampleFrames = anim->getCacheSampleFrames();
+				if (!anim->getCompressedCachePts().isEmpty())
+				{
+					animDataCache.m_numArrays = anim->getCompressedCachePts().getNumFrames();
+					FMemoryWriter writer(animDataCache.m_compressedPoints);
+					anim->getCompressedCachePts().serialize(writer);
+				}
+				else if (anim->hasCachePts())
 				{
 					auto &pts = anim->getCachePts();
 
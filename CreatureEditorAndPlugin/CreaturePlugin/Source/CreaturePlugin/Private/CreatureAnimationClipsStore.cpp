@@ -22,7 +22,15 @@ void UCreatureAnimationClipsStore::LoadAnimationDataToComponent(class UCreatureM
 			FCreatureMeshCollection CollectionData;
 			CollectionData.creature_filename = FName(*ShortClip.SourceAsset->GetName());
 			//ֱӸJsonStringãҪٴ
-			CollectionData.creature_core.pJsonData = &(ShortClip.SourceAsset->GetJsonString());
+			CollectionData.creature_core.pBinaryData = ShortClip.SourceAsset->GetCompiledBinary();
+			if (CollectionData.creature_core.pBinaryData == nullptr)
+			{
+				CollectionData.creature_core.pZipJsonData = ShortClip.SourceAsset->GetCompressedJson();
+			}
+			if ((CollectionData.creature_core.pBinaryData == nullptr) && (CollectionData.creature_core.pZipJsonData == nullptr))
+			{
+				CollectionData.creature_core.pJsonData = &(ShortClip.SourceAsset->GetJsonString());
+			}
 			
 			CollectionData.animation_speed = ShortClip.SourceAsset->animation_speed;
 			CollectionData.collection_material = ShortClip.SourceAsset->collection_material;
@@ -31,6 +39,8 @@ void UCreatureAnimationClipsStore::LoadAnimationDataToComponent(class UCreatureM
 			int32 Index = MeshComponent->collectionData.AddUnique(CollectionData);
 			FCreatureMeshCollection &addedCollectionData = MeshComponent->collectionData[Index];
 			addedCollectionData.creature_core.pJsonData = CollectionData.creature_core.pJsonData;
+			addedCollectionData.creature_core.pBinaryData = CollectionData.creature_core.pBinaryData;
+			addedCollectionData.creature_core.pZipJsonData = CollectionData.creature_core.pZipJsonData;
 			addedCollectionData.source_asset = ShortClip.SourceAsset;
 
 			FCreatureMeshCollectionToken Token = FCreatureMeshCollectionToken();
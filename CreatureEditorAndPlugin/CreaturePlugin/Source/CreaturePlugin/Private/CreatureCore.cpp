@@ -4,6 +4,7 @@
 #include "Engine/Engine.h"
 #include "HAL/PlatformFile.h"
 #include "HAL/PlatformFilemanager.h"
+#include "Async/Async.h"
 
 DECLARE_CYCLE_STAT(TEXT("CreatureCore_RunTick"), STAT_CreatureCore_RunTick, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureCore_UpdateCreatureRender"), STAT_CreatureCore_UpdateCreatureRender, STATGROUP_Creature);
@@ -11,9 +12,22 @@ DECLARE_CYCLE_STAT(TEXT("CreatureCore_FillBoneData"), STAT_CreatureCore_FillBone
 DECLARE_CYCLE_STAT(TEXT("CreatureCore_ParseEvents"), STAT_CreatureCore_ParseEvents, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureCore_UpdateManager"), STAT_CreatureCore_UpdateManager, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureCore_SetActiveAnimation"), STAT_CreatureCore_SetActiveAnimation, STATGROUP_Creature);
+DECLARE_CYCLE_STAT(TEXT("CreatureCore_BakeClip"), STAT_CreatureCore_BakeClip, STATGROUP_Creature);
+DECLARE_CYCLE_STAT(TEXT("CreatureCore_ApplyBakedFrame"), STAT_CreatureCore_ApplyBakedFrame, STATGROUP_Creature);
+
+// Packets are shared with the threads loading from them, so their reference counts have to be thread safe
+typedef TSharedPtr<CreatureModule::CreatureLoadDataPacket, ESPMode::ThreadSafe> FCreatureLoadDataPacketPtr;
 
 static TMap<FName, TSharedPtr<CreatureModule::CreatureAnimation> > global_animations;
-static TMap<FName, TSharedPtr<CreatureModule::CreatureLoadDataPacket> > global_load_data_packets;
+static TMap<FName, FCreatureLoadDataPacketPtr> global_load_data_packets;
+static TMap<FName, TSharedPtr<CreatureModule::Creature> > global_creature_prototypes;
+
+// Baked clips by GetBakedClipKey, freed once the last instance playing them lets go
+typedef TSharedPtr<CreatureModule::CreatureBakedClip, ESPMode::ThreadSafe> FCreatureBakedClipPtr;
+static TMap<FString, TWeakPtr<CreatureModule::CreatureBakedClip, ESPMode::ThreadSafe> > global_baked_clips;
+
+// Guards the registries above, creature data can be loaded from any thread
+static FCriticalSection global_registry_lock;
 
 // Misc Functions
 static FName GetAnimationToken(const FName& filename_in, const FName& name_in)
@@ -21,6 +35,22 @@ static FName GetAnimationToken(const FName& filename_in, const FName& name_in)
 	return FName(*FString::Printf(TEXT("%s_%s"), *filename_in.ToString(), *name_in.ToString()));
 }
 
+static bool IsDataPacketLoaded(const FName& filename_in)
+{
+	FScopeLock registry_lock(&global_registry_lock);
+	return global_load_data_packets.Contains(filename_in);
+}
+
+static void RegisterDataPacket(const FName& filename_in, const FCreatureLoadDataPacketPtr& packet_in)
+{
+	// Two threads can race to load the same data, the first one to finish is kept
+	FScopeLock registry_lock(&global_registry_lock);
+	if (!global_load_data_packets.Contains(filename_in))
+	{
+		global_load_data_packets.Add(filename_in, packet_in);
+	}
+}
+
 std::string ConvertToString(const FString &str)
 {
 	std::string t = TCHAR_TO_UTF8(*str);
@@ -66,6 +96,8 @@ int CreatureMeshDataModifier::numPoints() const
 CreatureCore::CreatureCore()
 {
 	pJsonData = nullptr;
+	pBinaryData = nullptr;
+	pZipJsonData = nullptr;
 	smooth_transitions = false;
 	bone_data_size = 0.01f;
 	bone_data_length_factor = 0.02f;
@@ -76,6 +108,8 @@ CreatureCore::CreatureCore()
 	play_end_done = false;
 	is_disabled = false;
 	is_driven = false;
+	bones_only_update = false;
+	use_baked_playback = false;
 	is_ready_play = false;
 	is_animation_loaded = false;
 	do_file_warning = true;
@@ -302,15 +336,65 @@ void CreatureCore::UpdateCreatureRender()
 
 bool CreatureCore::InitCreatureRender()
 {
-	FName cur_creature_filename = creature_filename;
-	bool init_success = false;
-	FName load_filename;
 	is_animation_loaded = false;
 
+	// Nothing left to load when the data was loaded ahead, asynchronously or by another instance
+	FCreatureLoadRequest load_request = MakeLoadRequest();
+	FName load_filename = load_request.load_filename;
+	bool init_success = LoadCreatureData(load_request);
+	
+	if (init_success)
+	{
+		LoadCreature(load_filename);
+		init_success = creature_manager.IsValid();
+	}
+
+	if (init_success)
+	{
+		// add all animations
+		auto all_animation_names = creature_manager->GetCreature()->GetAnimationNames();
+		auto first_animation_name = all_animation_names[0];
+		for (auto& cur_name : all_animation_names)
+		{
+			AddLoadedAnimation(load_filename, cur_name);
+		}
+
+		auto cur_str = start_animation_name;
+		for (auto& cur_name : all_animation_names)
+		{
+			if (cur_name == cur_str)
+			{
+				first_animation_name = cur_name;
+				break;
+			}
+		}
+
+		SetActiveAnimation(first_animation_name);
+
+		if (smooth_transitions)
+		{
+			creature_manager->SetAutoBlending(true);
+		}
+
+		FillBoneData();
+	}
+
+	is_animation_loaded = true;
+
+	return init_success;
+}
+
+FCreatureLoadRequest CreatureCore::MakeLoadRequest()
+{
+	FName cur_creature_filename = creature_filename;
+	FCreatureLoadRequest load_request;
+
 	//////////////////////////////////////////////////////////////////////////
 	//Changed by God of Pen
 	//////////////////////////////////////////////////////////////////////////
-	if (pJsonData != nullptr)
+	if (((pBinaryData != nullptr) && (pBinaryData->Num() > 0))
+		|| ((pZipJsonData != nullptr) && (pZipJsonData->Num() > 0))
+		|| (pJsonData != nullptr))
 	{
 		if (cur_creature_filename.IsNone())
 		{
@@ -318,10 +402,10 @@ bool CreatureCore::InitCreatureRender()
 		}
 
 		absolute_creature_filename = cur_creature_filename;
-		load_filename = cur_creature_filename;
-
-		// try to load creature
-		init_success = CreatureCore::LoadDataPacket(load_filename, pJsonData);
+		load_request.load_filename = cur_creature_filename;
+		load_request.pBinaryData = pBinaryData;
+		load_request.pZipJsonData = pZipJsonData;
+		load_request.pJsonData = pJsonData;
 	}
 	else{
 		FString curCreatureFilenameString = cur_creature_filename.ToString();
@@ -336,57 +420,121 @@ bool CreatureCore::InitCreatureRender()
 		if (does_exist)
 		{
 			absolute_creature_filename = cur_creature_filename;
-			load_filename = cur_creature_filename;
-
-			// try to load creature
-			CreatureCore::LoadDataPacket(load_filename);
-			init_success = true;
+			load_request.load_filename = cur_creature_filename;
 		}
 		else {
 
-			if (do_file_warning && (!load_filename.IsNone())) {
+			if (do_file_warning && (!load_request.load_filename.IsNone())) {
 				UE_LOG(LogTemp, Warning, TEXT("ACreatureActor::BeginPlay() - ERROR! Could not load creature file: %s"), *creature_filename.ToString());
 				GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("ACreatureActor::BeginPlay() - ERROR! Could not load creature file: %s"), *creature_filename.ToString()));
 			}
 		}
 	}
-	
-	if (init_success)
+
+	return load_request;
+}
+
+bool CreatureCore::LoadCreatureData(const FCreatureLoadRequest& request)
+{
+	const FName& load_filename = request.load_filename;
+	if (load_filename.IsNone())
 	{
-		LoadCreature(load_filename);
+		return false;
+	}
 
-		// try to load all animations
-		auto all_animation_names = creature_manager->GetCreature()->GetAnimationNames();
-		auto first_animation_name = all_animation_names[0];
-		for (auto& cur_name : all_animation_names)
-		{
-			CreatureCore::LoadAnimation(load_filename, cur_name);
-			AddLoadedAnimation(load_filename, cur_name);
-		}
+	if (IsCreatureDataLoaded(request))
+	{
+		return true;
+	}
 
-		auto cur_str = start_animation_name;
-		for (auto& cur_name : all_animation_names)
-		{
-			if (cur_name == cur_str)
-			{
-				first_animation_name = cur_name;
-				break;
-			}
-		}
+	bool init_success = false;
+	if ((request.pBinaryData != nullptr) && (request.pBinaryData->Num() > 0))
+	{
+		// try to load compiled creature
+		init_success = CreatureCore::LoadDataPacket(load_filename, request.pBinaryData, request.owned_bytes);
+	}
+	else if ((request.pZipJsonData != nullptr) && (request.pZipJsonData->Num() > 0))
+	{
+		// try to load compressed creature
+		init_success = CreatureCore::LoadCompressedDataPacket(load_filename, request.pZipJsonData);
+	}
+	else if (request.pJsonData != nullptr)
+	{
+		// try to load creature
+		init_success = CreatureCore::LoadDataPacket(load_filename, request.pJsonData);
+	}
+	else {
+		// try to load creature
+		init_success = CreatureCore::LoadDataPacket(load_filename);
+	}
 
-		SetActiveAnimation(first_animation_name);
+	FCreatureLoadDataPacketPtr load_data;
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		load_data = global_load_data_packets.FindRef(load_filename);
+	}
 
-		if (smooth_transitions)
-		{
-			creature_manager->SetAutoBlending(true);
-		}
+	if (!init_success || !load_data.IsValid())
+	{
+		return false;
+	}
 
-		FillBoneData();
+	// Animations go in before the prototype is registered, a registered prototype means the whole creature is loaded
+	TSharedPtr<CreatureModule::Creature> new_prototype(new CreatureModule::Creature(*load_data));
+	for (auto& cur_name : new_prototype->GetAnimationNames())
+	{
+		CreatureCore::LoadAnimation(load_filename, cur_name);
 	}
 
-	is_animation_loaded = true;
+	// Handed over whole, only the game thread shares the prototype and animations once they are registered
+	FScopeLock registry_lock(&global_registry_lock);
+	if (!global_creature_prototypes.Contains(load_filename))
+	{
+		global_creature_prototypes.Add(load_filename, MoveTemp(new_prototype));
+	}
 
-	return init_success;
+	return true;
+}
+
+void CreatureCore::LoadCreatureDataAsync(const FCreatureLoadRequest& request, TFunction<void(bool)> on_done)
+{
+	// Only the source that LoadCreatureData will pick is copied, the request keeps it alive
+	FCreatureLoadRequest pinned_request;
+	pinned_request.load_filename = request.load_filename;
+	if ((request.pBinaryData != nullptr) && (request.pBinaryData->Num() > 0))
+	{
+		pinned_request.owned_bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(*request.pBinaryData);
+		pinned_request.pBinaryData = pinned_request.owned_bytes.Get();
+	}
+	else if ((request.pZipJsonData != nullptr) && (request.pZipJsonData->Num() > 0))
+	{
+		pinned_request.owned_bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(*request.pZipJsonData);
+		pinned_request.pZipJsonData = pinned_request.owned_bytes.Get();
+	}
+	else if (request.pJsonData != nullptr)
+	{
+		pinned_request.owned_json = MakeShared<FString, ESPMode::ThreadSafe>(*request.pJsonData);
+		pinned_request.pJsonData = pinned_request.owned_json.Get();
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [pinned_request, on_done]()
+	{
+		const bool load_success = LoadCreatureData(pinned_request);
+
+		AsyncTask(ENamedThreads::GameThread, [load_success, on_done]()
+		{
+			if (on_done)
+			{
+				on_done(load_success);
+			}
+		});
+	});
+}
+
+bool CreatureCore::IsCreatureDataLoaded(const FCreatureLoadRequest& request)
+{
+	FScopeLock registry_lock(&global_registry_lock);
+	return global_creature_prototypes.Contains(request.load_filename);
 }
 
 void CreatureCore::InitValues()
@@ -477,17 +625,10 @@ void CreatureCore::ParseEvents(float deltaTime)
 	float cur_runtime = (creature_manager->getActualRunTime());
 	animation_frame = cur_runtime;
 
-	auto load_filename = absolute_creature_filename;
-
+	// The manager holds this instance's own references to the loaded animations,
+	// so the batch workers never have to take the registry lock here
 	auto cur_animation_name = creature_manager->GetActiveAnimationName();
-
-	auto cur_token = GetAnimationToken(load_filename, cur_animation_name);
-	CreatureModule::CreatureAnimation * cur_animation = NULL;
-	if (global_animations.Contains(cur_token))
-	{
-		cur_animation = global_animations[cur_token].Get();
-	}
-
+	CreatureModule::CreatureAnimation * cur_animation = creature_manager->GetAnimation(cur_animation_name);
 
 	if (cur_animation)
 	{
@@ -577,7 +718,7 @@ void CreatureCore::ProcessRenderRegions()
 bool 
 CreatureCore::LoadDataPacket(const FName& filename_in)
 {
-	if (global_load_data_packets.Contains(filename_in))
+	if (IsDataPacketLoaded(filename_in))
 	{
 		// file already loaded, just return
 		return true;
@@ -585,12 +726,34 @@ CreatureCore::LoadDataPacket(const FName& filename_in)
 	//////////////////////////////////////////////////////////////////////////
 	//Changed!
 	//////////////////////////////////////////////////////////////////////////
-	TSharedPtr<CreatureModule::CreatureLoadDataPacket> new_packet =
-		TSharedPtr<CreatureModule::CreatureLoadDataPacket>(new CreatureModule::CreatureLoadDataPacket());
+	FCreatureLoadDataPacketPtr new_packet =
+		FCreatureLoadDataPacketPtr(new CreatureModule::CreatureLoadDataPacket());
 
-	// load regular JSON
-	CreatureModule::LoadCreatureJSONData(filename_in, *new_packet);
-	global_load_data_packets[filename_in] = new_packet;
+	if (FPaths::GetExtension(filename_in.ToString()) == TEXT("creature_bin"))
+	{
+		// load compiled binary, memory mapped when possible
+		if (!CreatureModule::LoadCreatureBinaryData(filename_in, *new_packet))
+		{
+			return false;
+		}
+	}
+	else if (FPaths::GetExtension(filename_in.ToString()) == TEXT("zip"))
+	{
+		// load JSON packed in a zip archive
+		if (!CreatureModule::LoadCreatureZipJSONData(filename_in, *new_packet))
+		{
+			return false;
+		}
+	}
+	else {
+		// load regular JSON
+		if (!CreatureModule::LoadCreatureJSONData(filename_in, *new_packet))
+		{
+			return false;
+		}
+	}
+
+	RegisterDataPacket(filename_in, new_packet);
 
 	return true;
 }
@@ -603,7 +766,7 @@ bool CreatureCore::LoadDataPacket(const FName& filename_in, FString* pSourceData
 	{
 		return false;
 	}
-	if (global_load_data_packets.Contains(filename_in))
+	if (IsDataPacketLoaded(filename_in))
 	{
 		// file already loaded, just return
 		return true;
@@ -615,29 +778,105 @@ bool CreatureCore::LoadDataPacket(const FName& filename_in, FString* pSourceData
 			return false;
 		}
 
-		TSharedPtr<CreatureModule::CreatureLoadDataPacket> new_packet =
-			TSharedPtr<CreatureModule::CreatureLoadDataPacket>(new CreatureModule::CreatureLoadDataPacket);
+		FCreatureLoadDataPacketPtr new_packet =
+			FCreatureLoadDataPacketPtr(new CreatureModule::CreatureLoadDataPacket);
 
-		CreatureModule::LoadCreatureJSONDataFromString(*pSourceData, *new_packet);
-		global_load_data_packets.Add(filename_in, new_packet);
+		if (!CreatureModule::LoadCreatureJSONDataFromString(*pSourceData, *new_packet))
+		{
+			return false;
+		}
+
+		RegisterDataPacket(filename_in, new_packet);
 	}
 
 	return true;
 }
 
-void 
-CreatureCore::ClearAllDataPackets()
+bool CreatureCore::LoadDataPacket(const FName& filename_in, const TArray<uint8>* pBinarySource,
+	const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& pSourceOwner)
 {
-	for (auto& cur_packet : global_load_data_packets)
+	if (pBinarySource == nullptr)
 	{
-		cur_packet.Value->allocator.deallocate();
+		return false;
 	}
 
+	if (IsDataPacketLoaded(filename_in))
+	{
+		// file already loaded, just return
+		return true;
+	}
+
+	FCreatureLoadDataPacketPtr new_packet =
+		FCreatureLoadDataPacketPtr(new CreatureModule::CreatureLoadDataPacket);
+
+	if (!CreatureModule::LoadCreatureBinaryDataFromBuffer(*pBinarySource, *new_packet))
+	{
+		return false;
+	}
+
+	new_packet->binary_owner = pSourceOwner;
+
+	RegisterDataPacket(filename_in, new_packet);
+
+	return true;
+}
+
+bool CreatureCore::LoadCompressedDataPacket(const FName& filename_in, const TArray<uint8>* pZipSource)
+{
+	if (pZipSource == nullptr)
+	{
+		return false;
+	}
+
+	if (IsDataPacketLoaded(filename_in))
+	{
+		// file already loaded, just return
+		return true;
+	}
+
+	FCreatureLoadDataPacketPtr new_packet =
+		FCreatureLoadDataPacketPtr(new CreatureModule::CreatureLoadDataPacket);
+
+	if (!CreatureModule::LoadCreatureJSONDataFromCompressedBuffer(*pZipSource, *new_packet))
+	{
+		return false;
+	}
+
+	RegisterDataPacket(filename_in, new_packet);
+
+	return true;
+}
+
+bool
+CreatureCore::CompileDataPacket(const FName& filename_in, TArray<uint8>& binary_out, float bone_tolerance, float displacement_tolerance)
+{
+	FCreatureLoadDataPacketPtr load_data;
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		load_data = global_load_data_packets.FindRef(filename_in);
+	}
+
+	if (!load_data.IsValid())
+	{
+		return false;
+	}
+
+	return CreatureModule::CompileCreatureBinaryData(*load_data, binary_out, bone_tolerance, displacement_tolerance);
+}
+
+void 
+CreatureCore::ClearAllDataPackets()
+{
+	// The packets free their json when the last reference goes, which may be a thread still loading from one
+	FScopeLock registry_lock(&global_registry_lock);
 	global_load_data_packets.Empty();
+	global_creature_prototypes.Empty();
+	global_baked_clips.Empty();
 }
 
 void CreatureCore::FreeDataPacket(const FName & filename_in)
 {
+	FScopeLock registry_lock(&global_registry_lock);
 	if (global_load_data_packets.Contains(filename_in))
 	{
 		TArray<FName> remove_keys;
@@ -656,6 +895,27 @@ void CreatureCore::FreeDataPacket(const FName & filename_in)
 		}
 
 		global_load_data_packets.Remove(filename_in);
+		global_creature_prototypes.Remove(filename_in);
+	}
+}
+
+void CreatureCore::FreeBinaryDataPackets(const TArray<uint8>* pBinarySource)
+{
+	TArray<FName> free_filenames;
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		for (auto& packet_pair : global_load_data_packets)
+		{
+			if (packet_pair.Value->binary_data == pBinarySource->GetData())
+			{
+				free_filenames.Add(packet_pair.Key);
+			}
+		}
+	}
+
+	for (auto& cur_filename : free_filenames)
+	{
+		FreeDataPacket(cur_filename);
 	}
 }
 
@@ -663,37 +923,87 @@ void
 CreatureCore::LoadAnimation(const FName& filename_in, const FName& name_in)
 {
 	auto cur_token = GetAnimationToken(filename_in, name_in);
-	if (global_animations.Contains(cur_token))
+	FCreatureLoadDataPacketPtr load_data;
 	{
-		// animation already exists, just return
-		return;
+		FScopeLock registry_lock(&global_registry_lock);
+		if (global_animations.Contains(cur_token))
+		{
+			// animation already exists, just return
+			return;
+		}
+
+		load_data = global_load_data_packets.FindRef(filename_in);
 	}
 
-	if (global_load_data_packets.Contains(filename_in) == false)
+	if (!load_data.IsValid())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("CreatureCore::LoadAnimation() - Loading animation but %s was not loaded!"), *filename_in.ToString());
 		return;
 	}
 
-	auto load_data = global_load_data_packets[filename_in];
-
+	// Built outside the lock, the packet is kept alive by load_data even if it gets freed meanwhile
 	TSharedPtr<CreatureModule::CreatureAnimation> new_animation =
 		TSharedPtr<CreatureModule::CreatureAnimation>(
 			new CreatureModule::CreatureAnimation(*load_data, name_in));
 
-	global_animations.Add(cur_token, new_animation);
+	FScopeLock registry_lock(&global_registry_lock);
+	if (!global_animations.Contains(cur_token))
+	{
+		global_animations.Add(cur_token, MoveTemp(new_animation));
+	}
+}
+
+void
+CreatureCore::UnbindPointCache(const glm::float32 * pts_in)
+{
+	// Matched by pointer, the asset can be registered under more than one filename
+	FScopeLock registry_lock(&global_registry_lock);
+	for (auto& anim_pair : global_animations)
+	{
+		anim_pair.Value->unbindCachePts(pts_in);
+	}
 }
 
 TArray<FProceduralMeshTriangle>&
 CreatureCore::LoadCreature(const FName& filename_in)
 {
-	auto load_data = global_load_data_packets[filename_in];
+	// Build the prototype once per asset, every instance is then cloned from it
+	TSharedPtr<CreatureModule::Creature> prototype;
+	FCreatureLoadDataPacketPtr load_data;
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		prototype = global_creature_prototypes.FindRef(filename_in);
+		load_data = global_load_data_packets.FindRef(filename_in);
+	}
+
+	if (prototype.IsValid() == false)
+	{
+		if (load_data.IsValid() == false)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("CreatureCore::LoadCreature() - ERROR! No data packet loaded for: %s"), *filename_in.ToString());
+			creature_manager.Reset();
+			draw_triangles.Empty();
+			return draw_triangles;
+		}
+
+		// Built without holding the lock, if another thread registered one meanwhile that one is shared instead
+		TSharedPtr<CreatureModule::Creature> new_prototype(new CreatureModule::Creature(*load_data));
+
+		FScopeLock registry_lock(&global_registry_lock);
+		prototype = global_creature_prototypes.FindRef(filename_in);
+		if (prototype.IsValid() == false)
+		{
+			prototype = new_prototype;
+			global_creature_prototypes.Add(filename_in, prototype);
+		}
+	}
 
 	TSharedPtr<CreatureModule::Creature> new_creature =
-		TSharedPtr<CreatureModule::Creature>(new CreatureModule::Creature(*load_data));
+		TSharedPtr<CreatureModule::Creature>(new CreatureModule::Creature(*prototype));
 
 	creature_manager = TSharedPtr<CreatureModule::CreatureManager>(
 		new CreatureModule::CreatureManager(new_creature));
+	baked_clips.Empty();
 
 	draw_triangles.SetNum(creature_manager->GetCreature()->GetTotalNumIndices() / 3, true);
 
@@ -704,9 +1014,15 @@ bool
 CreatureCore::AddLoadedAnimation(const FName& filename_in, const FName& name_in)
 {
 	auto cur_token = GetAnimationToken(filename_in, name_in);
-	if (global_animations.Contains(cur_token))
+	TSharedPtr<CreatureModule::CreatureAnimation> cur_animation;
 	{
-		creature_manager->AddAnimation(global_animations[cur_token]);
+		FScopeLock registry_lock(&global_registry_lock);
+		cur_animation = global_animations.FindRef(cur_token);
+	}
+
+	if (cur_animation.IsValid())
+	{
+		creature_manager->AddAnimation(cur_animation);
 		creature_manager->SetIsPlaying(true);
 		creature_manager->SetShouldLoop(is_looping);
 		return true;
@@ -913,6 +1229,8 @@ CreatureCore::RunTick(float delta_time)
 	{
 		ParseEvents(delta_time);
 
+		const bool play_baked = CanPlayBakedClip();
+
 		if (should_play) {
 			SCOPE_CYCLE_COUNTER(STAT_CreatureCore_UpdateManager);
 
@@ -924,12 +1242,28 @@ CreatureCore::RunTick(float delta_time)
 			if (morph_targets_valid) {
 				meta_data->updateMorphStep(creature_manager.Get(), delta_time);
 			}
+			else if (play_baked) {
+				creature_manager->AdvanceTime(delta_time);
+			}
 			else {
 				creature_manager->Update(delta_time);
 			}
 		}
 
-		UpdateCreatureRender();
+		if (play_baked)
+		{
+			if (!bones_only_update)
+			{
+				ApplyBakedFrame();
+			}
+
+			return true;
+		}
+
+		if (!bones_only_update)
+		{
+			UpdateCreatureRender();
+		}
 		FillBoneData();
 	}
 
@@ -1126,6 +1460,346 @@ bool CreatureCore::GetGlobalEnablePointCache()
 	return cur_creature_manager->GetDoPointCache();
 }
 
+void CreatureCore::SetBonesOnlyUpdate(bool flag_in)
+{
+	bones_only_update = flag_in;
+
+	auto cur_creature_manager = GetCreatureManager();
+	if (cur_creature_manager != nullptr)
+	{
+		cur_creature_manager->SetBonesOnly(flag_in);
+	}
+}
+
+bool CreatureCore::BakeClip(const FName& name_in, bool can_share_in)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CreatureCore_BakeClip);
+
+	auto cur_creature_manager = GetCreatureManager();
+	if (!is_animation_loaded || (cur_creature_manager == nullptr))
+	{
+		return false;
+	}
+
+	auto cur_animation = cur_creature_manager->GetAnimation(name_in);
+	if (cur_animation == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CreatureCore::BakeClip - ERROR! Could not find animation %s"), *name_in.ToString());
+		return false;
+	}
+
+	if (!cur_creature_manager->IsPlayingSingleClip())
+	{
+		// Baked clips only ever play on their own, blended frames would not match them
+		UE_LOG(LogTemp, Warning, TEXT("CreatureCore::BakeClip - Can not bake %s while blending"), *name_in.ToString());
+		return false;
+	}
+
+	FScopeLock scope_lock(update_lock.Get());
+
+	// Another instance in the same state may have baked this clip already
+	const FString bake_key = can_share_in ? GetBakedClipKey(name_in) : FString();
+	if (!bake_key.IsEmpty())
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		FCreatureBakedClipPtr shared_clip = global_baked_clips.FindRef(bake_key).Pin();
+		if (shared_clip.IsValid())
+		{
+			baked_clips.Add(name_in, shared_clip);
+			return true;
+		}
+	}
+
+	auto cur_creature = cur_creature_manager->GetCreature();
+	const int32 num_pts = cur_creature->GetTotalNumPoints();
+	const int32 num_indices = cur_creature->GetTotalNumIndices();
+	const int32 start_time = (int32)cur_animation->getStartTime();
+
+	FCreatureBakedClipPtr new_clip(new CreatureModule::CreatureBakedClip());
+	new_clip->num_frames = (int32)cur_animation->getEndTime() - start_time + 1;
+	new_clip->num_pts = num_pts;
+	new_clip->pts.SetNumUninitialized(new_clip->num_frames * num_pts * 3);
+	new_clip->uvs.SetNumUninitialized(new_clip->num_frames * num_pts * 2);
+	new_clip->colors.SetNumUninitialized(new_clip->num_frames * num_pts);
+	new_clip->frame_index_orders.Init(-1, new_clip->num_frames);
+
+	// Pose through the regular update and render path so the bake matches live playback
+	const FName store_animation_name = cur_creature_manager->GetActiveAnimationName();
+	const float store_run_time = cur_creature_manager->getRunTime();
+	const bool store_is_playing = cur_creature_manager->GetIsPlaying();
+	const bool store_bones_only = cur_creature_manager->GetBonesOnly();
+	cur_creature_manager->SetActiveAnimationName(name_in);
+	cur_creature_manager->SetIsPlaying(true);
+	cur_creature_manager->SetBonesOnly(false);
+
+	auto& index_orders = new_clip->index_orders;
+	for (int32 i = 0; i < new_clip->num_frames; i++)
+	{
+		cur_creature_manager->setRunTime((float)(start_time + i));
+		cur_creature_manager->Update(0.0f);
+		UpdateCreatureRender();
+
+		FMemory::Memcpy(new_clip->pts.GetData() + (i * num_pts * 3), cur_creature->GetRenderPts(), sizeof(glm::float32) * num_pts * 3);
+		FMemory::Memcpy(new_clip->uvs.GetData() + (i * num_pts * 2), cur_creature->GetGlobalUvs(), sizeof(glm::float32) * num_pts * 2);
+		FMemory::Memcpy(new_clip->colors.GetData() + (i * num_pts), region_colors.GetData(), sizeof(FColor) * num_pts);
+
+		if (should_update_render_indices)
+		{
+			const int32 order_num = GetRealTotalIndicesNum();
+			const glm::uint32 * order_indices = GetIndicesCopy(num_indices);
+			const bool same_as_last = (index_orders.Num() > 0)
+				&& (index_orders.Last().Num() == order_num)
+				&& (FMemory::Memcmp(index_orders.Last().GetData(), order_indices, sizeof(glm::uint32) * order_num) == 0);
+
+			if (!same_as_last)
+			{
+				index_orders.AddDefaulted_GetRef().Append(order_indices, order_num);
+			}
+
+			new_clip->frame_index_orders[i] = index_orders.Num() - 1;
+		}
+	}
+
+	if (index_orders.Num() > 0)
+	{
+		// Once the order changes somewhere, every frame has to set one to undo it again
+		int32 default_order = INDEX_NONE;
+		for (int32& cur_order : new_clip->frame_index_orders)
+		{
+			if (cur_order < 0)
+			{
+				if (default_order == INDEX_NONE)
+				{
+					default_order = index_orders.Num();
+					index_orders.AddDefaulted_GetRef().Append(cur_creature->GetGlobalIndices(), num_indices);
+				}
+
+				cur_order = default_order;
+			}
+		}
+	}
+
+	cur_creature_manager->SetActiveAnimationName(store_animation_name);
+	cur_creature_manager->setRunTime(store_run_time);
+	cur_creature_manager->SetIsPlaying(store_is_playing);
+	cur_creature_manager->SetBonesOnly(store_bones_only);
+
+	baked_clips.Add(name_in, new_clip);
+
+	if (!bake_key.IsEmpty())
+	{
+		FScopeLock registry_lock(&global_registry_lock);
+		for (auto it = global_baked_clips.CreateIterator(); it; ++it)
+		{
+			if (!it.Value().IsValid())
+			{
+				it.RemoveCurrent();
+			}
+		}
+
+		global_baked_clips.Add(bake_key, new_clip);
+	}
+
+	return true;
+}
+
+FString CreatureCore::GetBakedClipKey(const FName& name_in)
+{
+	// Mesh modifiers rewrite the render data in ways the key can not describe
+	if (absolute_creature_filename.IsNone() || HasMeshModifier())
+	{
+		return FString();
+	}
+
+	auto cur_creature = creature_manager->GetCreature();
+	FString ret_key = FString::Printf(TEXT("%s|%s|meta:%p|mirror:%d|anchors:%d"),
+		*absolute_creature_filename.ToString(),
+		*name_in.ToString(),
+		meta_data,
+		creature_manager->GetMirrorY() ? 1 : 0,
+		cur_creature->GetAnchorPointsActive() ? 1 : 0);
+
+	if (shouldSkinSwap())
+	{
+		ret_key += FString::Printf(TEXT("|skin:%s"), *skin_swap_name);
+	}
+
+	auto appendSorted = [&ret_key](const TCHAR * label, TArray<FString>& entries)
+	{
+		entries.Sort();
+		ret_key += FString::Printf(TEXT("|%s:%s"), label, *FString::Join(entries, TEXT(",")));
+	};
+
+	TArray<FString> color_entries;
+	for (auto& color_pair : region_colors_map)
+	{
+		color_entries.Add(color_pair.Key.ToString() + TEXT("=") + color_pair.Value.ToHex());
+	}
+
+	appendSorted(TEXT("colors"), color_entries);
+
+	TArray<FString> swap_entries;
+	for (auto& swap_pair : cur_creature->GetActiveItemSwaps())
+	{
+		swap_entries.Add(FString::Printf(TEXT("%s=%d"), *swap_pair.Key.ToString(), swap_pair.Value));
+	}
+
+	appendSorted(TEXT("swaps"), swap_entries);
+
+	// Region order is applied as given, so it is not sorted
+	ret_key += TEXT("|order:");
+	for (auto& cur_name : region_custom_order)
+	{
+		ret_key += cur_name.ToString() + TEXT(",");
+	}
+
+	return ret_key;
+}
+
+void CreatureCore::SetBoneSpaceBlending(bool flag_in)
+{
+	auto cur_creature_manager = GetCreatureManager();
+	if (cur_creature_manager == nullptr)
+	{
+		return;
+	}
+
+	FScopeLock scope_lock(update_lock.Get());
+	cur_creature_manager->SetBoneSpaceBlending(flag_in);
+}
+
+bool CreatureCore::GetBoneSpaceBlending()
+{
+	auto cur_creature_manager = GetCreatureManager();
+	return cur_creature_manager ? cur_creature_manager->GetBoneSpaceBlending() : false;
+}
+
+void CreatureCore::SetBlendGraph(const TArray<CreatureModule::CreatureBlendClip>& clips_in,
+	const TArray<CreatureModule::CreatureBlendLayer>& layers_in)
+{
+	auto cur_creature_manager = GetCreatureManager();
+	if (cur_creature_manager == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CreatureCore::SetBlendGraph() - ERROR! no CreatureManager"));
+		return;
+	}
+
+	FScopeLock scope_lock(update_lock.Get());
+	cur_creature_manager->SetBlendGraph(clips_in, layers_in);
+}
+
+void CreatureCore::ClearBlendGraph()
+{
+	auto cur_creature_manager = GetCreatureManager();
+	if (cur_creature_manager == nullptr)
+	{
+		return;
+	}
+
+	FScopeLock scope_lock(update_lock.Get());
+	cur_creature_manager->ClearBlendGraph();
+}
+
+void CreatureCore::ClearBakedClip(const FName& name_in)
+{
+	auto cur_creature_manager = GetCreatureManager();
+	if (cur_creature_manager == nullptr)
+	{
+		return;
+	}
+
+	FScopeLock scope_lock(update_lock.Get());
+	baked_clips.Remove(name_in);
+}
+
+void CreatureCore::SetBakedPlayback(bool flag_in)
+{
+	use_baked_playback = flag_in;
+}
+
+bool CreatureCore::GetBakedPlayback() const
+{
+	return use_baked_playback;
+}
+
+bool CreatureCore::CanPlayBakedClip()
+{
+	if (!use_baked_playback || (creature_manager.Get() == nullptr))
+	{
+		return false;
+	}
+
+	if (run_morph_targets && meta_data && meta_data->morph_data.isValid())
+	{
+		return false;
+	}
+
+	if (!creature_manager->IsPlayingSingleClip())
+	{
+		return false;
+	}
+
+	const FName cur_animation_name = creature_manager->GetActiveAnimationName();
+	if (creature_manager->GetAnimation(cur_animation_name) == nullptr)
+	{
+		return false;
+	}
+
+	const FCreatureBakedClipPtr baked_clip = baked_clips.FindRef(cur_animation_name);
+	return baked_clip.IsValid()
+		&& (baked_clip->num_frames > 0)
+		&& (baked_clip->num_pts == creature_manager->GetCreature()->GetTotalNumPoints());
+}
+
+void CreatureCore::ApplyBakedFrame()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CreatureCore_ApplyBakedFrame);
+
+	auto cur_creature = creature_manager->GetCreature();
+	const FName cur_animation_name = creature_manager->GetActiveAnimationName();
+	auto cur_animation = creature_manager->GetAnimation(cur_animation_name);
+	const CreatureModule::CreatureBakedClip& baked_clip = *baked_clips.FindChecked(cur_animation_name);
+	const int32 num_pts = baked_clip.num_pts;
+
+	const float local_time = FMath::Clamp(creature_manager->getRunTime() - cur_animation->getStartTime(),
+		0.0f, (float)(baked_clip.num_frames - 1));
+	const int32 floor_idx = FMath::FloorToInt(local_time);
+	const int32 ceil_idx = FMath::Min(floor_idx + 1, baked_clip.num_frames - 1);
+	const float ratio = local_time - (float)floor_idx;
+	// Discrete data like swapped uvs, colours and orders comes from the nearest frame
+	const int32 nearest_idx = (ratio < 0.5f) ? floor_idx : ceil_idx;
+
+	const glm::float32 * floor_pts = baked_clip.pts.GetData() + (floor_idx * num_pts * 3);
+	const glm::float32 * ceil_pts = baked_clip.pts.GetData() + (ceil_idx * num_pts * 3);
+	glm::float32 * render_pts = cur_creature->GetRenderPts();
+	for (int32 i = 0; i < num_pts * 3; i++)
+	{
+		render_pts[i] = floor_pts[i] + (ratio * (ceil_pts[i] - floor_pts[i]));
+	}
+
+	FMemory::Memcpy(cur_creature->GetGlobalUvs(), baked_clip.uvs.GetData() + (nearest_idx * num_pts * 2), sizeof(glm::float32) * num_pts * 2);
+
+	if (region_colors.Num() != num_pts)
+	{
+		region_colors.SetNumUninitialized(num_pts);
+	}
+
+	FMemory::Memcpy(region_colors.GetData(), baked_clip.colors.GetData() + (nearest_idx * num_pts), sizeof(FColor) * num_pts);
+
+	const int32 order_idx = baked_clip.frame_index_orders[nearest_idx];
+	if (order_idx >= 0)
+	{
+		const TArray<glm::uint32>& cur_order = baked_clip.index_orders[order_idx];
+		FMemory::Memcpy(GetIndicesCopy(cur_creature->GetTotalNumIndices()), cur_order.GetData(), sizeof(glm::uint32) * cur_order.Num());
+		region_order_indices_num = cur_order.Num();
+		should_update_render_indices = true;
+	}
+	else {
+		region_order_indices_num = 0;
+		should_update_render_indices = false;
+	}
+}
+
 glm::uint32 * CreatureCore::GetIndicesCopy(int init_size)
 {
 	if (!global_indices_copy)
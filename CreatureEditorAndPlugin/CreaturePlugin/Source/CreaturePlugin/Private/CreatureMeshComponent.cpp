@@ -7,8 +7,11 @@
 //////////////////////////////////////////////////////////////////////////
 #include "CreatureAnimationClipsStore.h"
 #include "CreatureAnimStateMachineInstance.h"
-#include "Async/Async.h"
+#include "CreatureWorldSubsystem.h"
 #include "DrawDebugHelpers.h"
+#include "SceneManagement.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
 #include <math.h>
 
 #ifdef _WIN32
@@ -25,7 +28,6 @@
 
 
 DECLARE_CYCLE_STAT(TEXT("CreatureMesh_Tick"), STAT_CreatureMesh_Tick, STATGROUP_Creature);
-DECLARE_CYCLE_STAT(TEXT("CreatureMesh_AsyncTick"), STAT_CreatureMesh_Tick_Async, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureMesh_UpdateCoreValues"), STAT_CreatureMesh_UpdateCoreValues, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureMesh_MeshUpdate"), STAT_CreatureMesh_MeshUpdate, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureMesh_ProcessCreatureCoreResults"), STAT_CreatureMesh_ProcessCreatureCoreResults, STATGROUP_Creature);
@@ -36,18 +38,12 @@ UCreatureMeshComponent::UCreatureMeshComponent(const FObjectInitializer& ObjectI
 {
 	PrimaryComponentTick.bCanEverTick = true;
 
-	EndPhysicsTickFunction.TickGroup = TG_PostPhysics;
-	EndPhysicsTickFunction.bCanEverTick = true;
-	EndPhysicsTickFunction.bStartWithTickEnabled = true;
-	EndPhysicsTickFunction.bTickEvenWhenPaused = false;
-
 	InitStandardValues();
 }
 
 void UCreatureMeshComponent::SetBluePrintAlwaysTick(bool flag_in)
 {
 	PrimaryComponentTick.bTickEvenWhenPaused = flag_in;
-	EndPhysicsTickFunction.bTickEvenWhenPaused = flag_in;
 }
 
 void UCreatureMeshComponent::SetBluePrintActiveAnimation(FString name_in)
@@ -143,6 +139,65 @@ bool UCreatureMeshComponent::GetBluePrintUsePointCache()
 	return creature_core.GetGlobalEnablePointCache();
 }
 
+void UCreatureMeshComponent::SetBluePrintBoneSpaceBlending(bool flag_in)
+{
+	creature_core.SetBoneSpaceBlending(flag_in);
+}
+
+bool UCreatureMeshComponent::GetBluePrintBoneSpaceBlending()
+{
+	return creature_core.GetBoneSpaceBlending();
+}
+
+void UCreatureMeshComponent::SetBluePrintBlendGraph(const TArray<FCreatureBlendGraphClip>& clips_in, const TArray<FCreatureBlendGraphLayer>& layers_in)
+{
+	TArray<CreatureModule::CreatureBlendClip> graph_clips;
+	graph_clips.Reserve(clips_in.Num());
+	for (const auto& cur_clip : clips_in)
+	{
+		graph_clips.Add(CreatureModule::CreatureBlendClip(cur_clip.animation_name, cur_clip.weight));
+	}
+
+	TArray<CreatureModule::CreatureBlendLayer> graph_layers;
+	graph_layers.SetNum(layers_in.Num());
+	for (int32 i = 0; i < layers_in.Num(); i++)
+	{
+		graph_layers[i].animation_name = layers_in[i].animation_name;
+		graph_layers[i].weight = layers_in[i].weight;
+		graph_layers[i].additive = layers_in[i].additive;
+		graph_layers[i].bone_mask = layers_in[i].bone_mask;
+	}
+
+	creature_core.SetBlendGraph(graph_clips, graph_layers);
+}
+
+void UCreatureMeshComponent::ClearBluePrintBlendGraph()
+{
+	creature_core.ClearBlendGraph();
+}
+
+bool UCreatureMeshComponent::BakeBluePrintClip_Name(FName name_in)
+{
+	// Overridden bones are specific to this mesh, so its bakes are not shared
+	const bool can_share = (bones_override_list.Num() == 0) && (internal_ik_map.Num() == 0);
+	return creature_core.BakeClip(name_in, can_share);
+}
+
+void UCreatureMeshComponent::ClearBluePrintBakedClip_Name(FName name_in)
+{
+	creature_core.ClearBakedClip(name_in);
+}
+
+void UCreatureMeshComponent::SetBluePrintUseBakedPlayback(bool flag_in)
+{
+	creature_core.SetBakedPlayback(flag_in);
+}
+
+bool UCreatureMeshComponent::GetBluePrintUseBakedPlayback()
+{
+	return creature_core.GetBakedPlayback();
+}
+
 FTransform UCreatureMeshComponent::GetBluePrintBoneXform(FString name_in, bool world_transform, float position_slide_factor)
 {
 	return creature_core.GetBluePrintBoneXform(FName(*name_in), world_transform, position_slide_factor, GetComponentToWorld());
@@ -530,6 +585,19 @@ void UCreatureMeshComponent::InitStandardValues()
 	fixed_timestep = 0.0f;
 	run_task_multicore = false;
 	use_anchor_points = false;
+	load_async = false;
+	enable_animation_lod = false;
+	lod_reduced_rate_screen_size = 0.1f;
+	lod_reduced_rate_frames = 3;
+	lod_point_cache_screen_size = 0.03f;
+	lod_offscreen_bones_only = true;
+	lod_significance_scale = 1.0f;
+	animation_lod = ECreatureAnimationLOD::Full;
+	lod_frame_counter = 0;
+	lod_skipped_time = 0;
+	lod_budget_interval = 1;
+	lod_update_cost = 0;
+	async_load_serial = 0;
 
 	// Generate a single dummy triangle
 	/*
@@ -549,7 +617,15 @@ void UCreatureMeshComponent::UpdateCoreValues()
 
 	if (creature_animation_asset && creature_core.creature_asset_filename != creature_animation_asset->GetCreatureFilename())
 	{
-		creature_core.pJsonData = &creature_animation_asset->GetJsonString();
+		creature_core.pBinaryData = creature_animation_asset->GetCompiledBinary();
+		if (creature_core.pBinaryData == nullptr)
+		{
+			creature_core.pZipJsonData = creature_animation_asset->GetCompressedJson();
+		}
+		if ((creature_core.pBinaryData == nullptr) && (creature_core.pZipJsonData == nullptr))
+		{
+			creature_core.pJsonData = &creature_animation_asset->GetJsonString();
+		}
 		creature_core.creature_asset_filename = creature_animation_asset->GetCreatureFilename();
 
 		creature_animation_asset->LoadPointCacheForAllClips(&creature_core);
@@ -615,17 +691,10 @@ void UCreatureMeshComponent::RunTick(float DeltaTime)
 	}
 
 	// Run the animation
-	if (run_task_multicore) {
-		// Make sure this only runs for characters that will not be removed from the scene
-		// otherwise it might not be safe
-
-		TFunction<bool()> aTask = [this, DeltaTime]() -> bool
-		{
-			SCOPE_CYCLE_COUNTER(STAT_CreatureMesh_Tick_Async);
-			return RunTickProcessing(DeltaTime, false);
-		};
-
-		creatureTickResult = Async(EAsyncExecution::TaskGraph, aTask);
+	UCreatureWorldSubsystem * world_subsystem = run_task_multicore ? GetWorld()->GetSubsystem<UCreatureWorldSubsystem>() : nullptr;
+	if (world_subsystem) {
+		// Updated together with all other multicore characters of the world
+		world_subsystem->QueueTick(this, DeltaTime);
 	}
 	else {
 		auto can_tick = RunTickProcessing(DeltaTime, true);
@@ -638,6 +707,8 @@ void UCreatureMeshComponent::RunTick(float DeltaTime)
 
 bool UCreatureMeshComponent::RunTickProcessing(float DeltaTime, bool markDirty)
 {
+	const double start_time = FPlatformTime::Seconds();
+
 	// Run the animation
 	bool can_tick = creature_core.RunTick(DeltaTime);
 
@@ -646,50 +717,151 @@ bool UCreatureMeshComponent::RunTickProcessing(float DeltaTime, bool markDirty)
 		FScopeLock cur_lock(&local_lock);
 
 		animation_frame = creature_core.GetCreatureManager()->getActualRunTime();
-		DoCreatureMeshUpdate(INDEX_NONE, markDirty);		
+		if (!creature_core.bones_only_update)
+		{
+			DoCreatureMeshUpdate(INDEX_NONE, markDirty);
+		}
 		TryCreateBendPhysics();
 	}
 
+	const float cur_cost = (float)((FPlatformTime::Seconds() - start_time) * 1000.0);
+	lod_update_cost = FMath::Lerp(lod_update_cost, cur_cost, 0.25f);
+
 	return can_tick;
 }
 
-void UCreatureMeshComponent::ProcessCreatureCoreResult(FCreatureCoreResultTickFunction& ThisTickFunction)
+ECreatureAnimationLOD UCreatureMeshComponent::GetAnimationLOD() const
+{
+	return animation_lod;
+}
+
+void UCreatureMeshComponent::SetLODBudgetInterval(int32 interval_in)
+{
+	lod_budget_interval = FMath::Max(interval_in, 1);
+}
+
+float UCreatureMeshComponent::ComputeLODScreenSize() const
 {
-	if (ShouldSkipTick() || (!run_task_multicore))
+	// Largest screen size over the local player cameras, so field of view and aspect ratio count
+	float max_screen_size = -1.0f;
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
 	{
-		return;
+		const APlayerController * cur_controller = it->Get();
+		if (cur_controller && cur_controller->IsLocalController() && cur_controller->PlayerCameraManager)
+		{
+			const FMinimalViewInfo& view_info = cur_controller->PlayerCameraManager->GetCameraCacheView();
+			max_screen_size = FMath::Max(max_screen_size,
+				ComputeBoundsScreenSize(Bounds.Origin, Bounds.SphereRadius, view_info.Location, view_info.CalculateProjectionMatrix()));
+		}
 	}
 
-	SCOPE_CYCLE_COUNTER(STAT_CreatureMesh_ProcessCreatureCoreResults);
-	
-	bool can_tick = creatureTickResult.IsValid() && creatureTickResult.Get();
+	if (max_screen_size >= 0.0f)
+	{
+		return max_screen_size;
+	}
 
-	if (can_tick)
+	// No player cameras, e.g. in editor viewports. Assume a 90 degree field of view at the rendered views
+	const TArray<FVector>& view_locations = GetWorld()->ViewLocationsRenderedLastFrame;
+	if (view_locations.Num() == 0)
 	{
-		FScopeLock cur_lock(&local_lock);
+		return 1.0f;
+	}
+
+	const FMatrix default_proj = FPerspectiveMatrix(HALF_PI * 0.5f, 1.0f, 1.0f, GNearClippingPlane);
+	for (const FVector& cur_location : view_locations)
+	{
+		max_screen_size = FMath::Max(max_screen_size,
+			ComputeBoundsScreenSize(Bounds.Origin, Bounds.SphereRadius, cur_location, default_proj));
+	}
+
+	return max_screen_size;
+}
+
+bool UCreatureMeshComponent::UpdateAnimationLOD(float& delta_time)
+{
+	UCreatureWorldSubsystem * world_subsystem = GetWorld()->GetSubsystem<UCreatureWorldSubsystem>();
+	const bool use_lod = world_subsystem ? world_subsystem->ShouldUseAnimationLOD(enable_animation_lod) : false;
 
-		// mark the ActorComponent dirty flags based on the result of the creature update
-		// Need to recreate scene proxy to send it over
-		if (recreate_render_proxy)
+	ECreatureAnimationLOD new_lod = ECreatureAnimationLOD::Full;
+	float screen_size = 1.0f;
+	if (use_lod)
+	{
+		screen_size = ComputeLODScreenSize();
+		if (lod_offscreen_bones_only && !WasRecentlyRendered())
 		{
-			MarkRenderStateDirty();
-			recreate_render_proxy = false;
+			new_lod = ECreatureAnimationLOD::BonesOnly;
 		}
-		else
+		else if (screen_size < lod_point_cache_screen_size)
 		{
-			FCProceduralMeshSceneProxy *localRenderProxy = GetLocalRenderProxy();
-			if (render_proxy_ready && localRenderProxy)
-			{
-				MarkRenderTransformDirty();
-
-				check(localRenderProxy->GetDoesActiveRenderPacketHaveVertices());
-				MarkRenderDynamicDataDirty();
-			}
+			new_lod = ECreatureAnimationLOD::PointCacheOnly;
 		}
+		else if (screen_size < lod_reduced_rate_screen_size)
+		{
+			new_lod = ECreatureAnimationLOD::ReducedRate;
+		}
+	}
 
-		// fire events
-		FireStartEndEvents();
+	if (new_lod != animation_lod)
+	{
+		creature_core.SetBonesOnlyUpdate(new_lod == ECreatureAnimationLOD::BonesOnly);
+		creature_core.SetGlobalEnablePointCache(can_use_point_cache || (new_lod == ECreatureAnimationLOD::PointCacheOnly));
+		animation_lod = new_lod;
 	}
+
+	const int32 lod_interval = (animation_lod == ECreatureAnimationLOD::ReducedRate) ? FMath::Max(lod_reduced_rate_frames, 1) : 1;
+
+	// The budget interval came from the last arbitration, the next one hands out a new one
+	const int32 budget_interval = lod_budget_interval;
+	lod_budget_interval = 1;
+	if (use_lod)
+	{
+		world_subsystem->ReportAnimationLOD(this, screen_size * lod_significance_scale, lod_update_cost / lod_interval);
+	}
+
+	lod_skipped_time += delta_time;
+	lod_frame_counter++;
+	if (lod_frame_counter < (lod_interval * budget_interval))
+	{
+		return false;
+	}
+
+	delta_time = lod_skipped_time;
+	lod_skipped_time = 0;
+	lod_frame_counter = 0;
+	return true;
+}
+
+void UCreatureMeshComponent::PublishCreatureCoreResult()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CreatureMesh_ProcessCreatureCoreResults);
+
+	FScopeLock cur_lock(&local_lock);
+
+	// mark the ActorComponent dirty flags based on the result of the creature update
+	// Need to recreate scene proxy to send it over
+	if (creature_core.bones_only_update)
+	{
+		// mesh was not updated
+	}
+	else if (recreate_render_proxy)
+	{
+		MarkRenderStateDirty();
+		recreate_render_proxy = false;
+	}
+	else
+	{
+		FCProceduralMeshSceneProxy *localRenderProxy = GetLocalRenderProxy();
+		if (render_proxy_ready && localRenderProxy)
+		{
+			MarkRenderTransformDirty();
+
+			check(localRenderProxy->GetDoesActiveRenderPacketHaveVertices());
+			MarkRenderDynamicDataDirty();
+		}
+	}
+
+	// fire events
+	FireStartEndEvents();
 }
 
 void 
@@ -949,11 +1121,7 @@ void UCreatureMeshComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	bool shouldSkipTick = ShouldSkipTick();
-	
-	RegisterCoreResultsTickFunction(!shouldSkipTick && !enable_collection_playback);
-
-	if (shouldSkipTick)
+	if (ShouldSkipTick())
 	{
 		return;
 	}
@@ -978,26 +1146,15 @@ void UCreatureMeshComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 			{
 				real_delta_time = fixed_timestep;
 			}
-			
-			RunTick(real_delta_time);
+
+			if (UpdateAnimationLOD(real_delta_time))
+			{
+				RunTick(real_delta_time);
+			}
 		}
 	}
 }
 
-void FCreatureCoreResultTickFunction::ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
-{
-	QUICK_SCOPE_CYCLE_COUNTER(FCreatureCoreResultTickFunction_ExecuteTick);
-	FActorComponentTickFunction::ExecuteTickHelper(Target, /*bTickInEditor=*/ false, DeltaTime, TickType, [this](float DilatedTime)
-	{
-		Target->ProcessCreatureCoreResult(*this);
-	});
-}
-
-FString FCreatureCoreResultTickFunction::DiagnosticMessage()
-{
-	return TEXT("FCreatureMeshComponentEndPhysicsTickFunction");
-}
-
 void UCreatureMeshComponent::OnRegister()
 {
 	Super::OnRegister();
@@ -1012,38 +1169,24 @@ void UCreatureMeshComponent::OnRegister()
 	}
 }
 
-void UCreatureMeshComponent::RegisterComponentTickFunctions(bool bRegister)
-{
-	Super::RegisterComponentTickFunctions(bRegister);
-
-	RegisterCoreResultsTickFunction(bRegister && !enable_collection_playback);
-}
-
-void UCreatureMeshComponent::RegisterCoreResultsTickFunction(bool bRegister)
-{
-	if (bRegister != EndPhysicsTickFunction.IsTickFunctionRegistered())
-	{
-		if (bRegister)
-		{
-			if (SetupActorComponentTickFunction(&EndPhysicsTickFunction))
-			{
-				EndPhysicsTickFunction.Target = this;
-			}
-		}
-		else
-		{
-			EndPhysicsTickFunction.UnRegisterTickFunction();
-		}
-	}
-}
-
 void UCreatureMeshComponent::StandardInit()
 {
 	creature_core.ClearMemory();
 	creature_core = CreatureCore();
+	animation_lod = ECreatureAnimationLOD::Full;
+	async_load_serial++;
 
 	UpdateCoreValues();
 	creature_core.do_file_warning = !enable_collection_playback;
+
+	if (load_async && StartAsyncLoad())
+	{
+		// Without a creature manager the component neither ticks nor draws until the load is done
+		static FProceduralMeshTriData empty_data;
+		SetProceduralMeshTriData(empty_data);
+		return;
+	}
+
 	bool retval = creature_core.InitCreatureRender();
 	creature_core.InitValues();
 
@@ -1079,6 +1222,38 @@ void UCreatureMeshComponent::StandardInit()
 	}
 }
 
+bool UCreatureMeshComponent::StartAsyncLoad()
+{
+	FCreatureLoadRequest load_request = creature_core.MakeLoadRequest();
+	if (load_request.load_filename.IsNone() || CreatureCore::IsCreatureDataLoaded(load_request))
+	{
+		// Instancing already loaded data is cheap enough to do right away
+		return false;
+	}
+
+	const int32 cur_serial = async_load_serial;
+	TWeakObjectPtr<UCreatureMeshComponent> weak_this(this);
+	const FName load_filename = load_request.load_filename;
+	CreatureCore::LoadCreatureDataAsync(load_request, [weak_this, cur_serial, load_filename](bool load_success)
+	{
+		if (!load_success)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UCreatureMeshComponent::StartAsyncLoad() - ERROR! Could not load creature data: %s"), *load_filename.ToString());
+			return;
+		}
+
+		UCreatureMeshComponent * cur_component = weak_this.Get();
+		if (cur_component && cur_component->IsRegistered()
+			&& (cur_component->async_load_serial == cur_serial))
+		{
+			// The data is loaded now, so this init goes through synchronously
+			cur_component->StandardInit();
+		}
+	});
+
+	return true;
+}
+
 void UCreatureMeshComponent::CollectionInit()
 {
 	RecreateRenderProxy(true);
@@ -121,16 +121,40 @@ void CreatureMetaData::updateRegionColors(TMap<FName, TSharedPtr<CreatureModule:
 		{
 			const auto& clip_regions_data =	anim_region_colors[clip_name];
 			auto& opacity_cache = clip_anim->getOpacityCache();
+
+			// The opacity cache only keeps its own keys, so every frame with colors gets one too
+			TArray<int32> color_frames;
+			for (auto& region_pair : clip_regions_data)
+			{
+				const auto& read_anim_data = region_pair.Value;
+				for (int idx = 0; idx < read_anim_data.Num(); idx++)
+				{
+					if (read_anim_data[idx].frame == (opacity_cache.getStartTime() + idx))
+					{
+						color_frames.Add(idx);
+					}
+				}
+			}
+
+			opacity_cache.insertKeys(color_frames);
+
 			auto& opacity_table = opacity_cache.getCacheTable();
-			for (int m = opacity_cache.getStartTime(); m <= opacity_cache.getEndime(); m++)
+			const auto& key_frames = opacity_cache.getKeyFrames();
+			for (int k = 0; k < key_frames.Num(); k++)
 			{
-				auto idx = opacity_cache.getIndexByTime(m);
-				auto& regions_data = opacity_table[idx];
+				auto idx = key_frames[k];
+				auto m = opacity_cache.getStartTime() + idx;
+				auto& regions_data = opacity_table[k];
 				for (auto& cur_region : regions_data)
 				{
 					if (clip_regions_data.Contains(cur_region.getKey().ToString()))
 					{
 						auto& read_anim_data = clip_regions_data[cur_region.getKey().ToString()];
+						if (read_anim_data.IsValidIndex(idx) == false)
+						{
+							continue;
+						}
+
 						const auto& read_colors_data = read_anim_data[idx];
 						if (read_colors_data.frame == m)
 						{
@@ -155,79 +179,46 @@ void CreatureMetaData::updateMorphStep(
 	CreatureModule::CreatureManager * manager_in,
 	float delta_step)
 {
-	auto creature_in = manager_in->GetCreature();
-	if (morph_data.play_anims_data.Num() == 0)
+	if (morph_data.play_clips.Num() == 0)
 	{
-		auto& all_clips = manager_in->GetAllAnimations();
-		morph_data.play_anims_data.SetNum(morph_data.morph_clips.Num());
-		for (int32 i = 0; i < morph_data.play_anims_data.Num(); i++)
+		for (int32 i = 0; i < morph_data.morph_clips.Num(); i++)
 		{
-			auto& cur_play_data = morph_data.play_anims_data[i];
-			cur_play_data.Get<0>() = FName(*morph_data.morph_clips[i].Get<0>());
-			const auto& cur_clip_name = cur_play_data.Get<0>();
-			cur_play_data.Get<1>() = all_clips[cur_clip_name]->getStartTime();
+			morph_data.play_clips.Add(CreatureModule::CreatureBlendClip(FName(*morph_data.morph_clips[i].Get<0>()), 0));
 		}
 
 		if (morph_data.center_clip.Len() > 0)
 		{
-			morph_data.play_center_anim_data.Get<0>() = FName(*morph_data.center_clip);
-			const auto& center_clip_name = morph_data.play_center_anim_data.Get<0>();
-			morph_data.play_center_anim_data.Get<1>() = all_clips[center_clip_name]->getStartTime();
+			morph_data.play_clips.Add(CreatureModule::CreatureBlendClip(FName(*morph_data.center_clip), 0));
 		}
 
-		morph_data.play_pts.SetNum(creature_in->GetTotalNumPoints() * 3);
-	}
-
-	FMemory::Memset(morph_data.play_pts.GetData(), 0, sizeof(glm::float32) * morph_data.play_pts.Num());
-
-	auto updatePoints = [this, creature_in](float ratio_in)
-	{
-		auto render_pts = morph_data.play_pts.GetData();
-		for (int j = 0; j < creature_in->GetTotalNumPoints() * 3; j += 3)
+		// Every morph clip keeps its own run time
+		auto& all_clips = manager_in->GetAllAnimations();
+		morph_data.play_run_times.SetNum(morph_data.play_clips.Num());
+		for (int32 i = 0; i < morph_data.play_clips.Num(); i++)
 		{
-			render_pts[j] +=
-				(creature_in->GetRenderPts()[j] * ratio_in);
-			render_pts[j + 1] +=
-				(creature_in->GetRenderPts()[j + 1] * ratio_in);
+			const auto * cur_clip = all_clips.Find(morph_data.play_clips[i].animation_name);
+			morph_data.play_run_times[i] = cur_clip ? (*cur_clip)->getStartTime() : 0.0f;
 		}
-	};
+	}
 
 	float center_ratio = 0;
 	bool has_center = (morph_data.center_clip.Len() > 0);
 	if (has_center)
 	{
-		auto radius = (float)morph_data.morph_res * 0.5f;
 		auto test_pt = morph_data.play_img_pt - FVector2D(morph_data.morph_res / 2, morph_data.morph_res / 2);
-		center_ratio = FVector2D::Distance(
-			test_pt / ((float)morph_data.morph_res * 0.5f), FVector2D::ZeroVector);
-
-		const auto& clip_name = morph_data.play_center_anim_data.Get<0>();
-		manager_in->SetActiveAnimationName(clip_name);
-		manager_in->setRunTime(morph_data.play_center_anim_data.Get<1>());
-		manager_in->Update(delta_step);
+		center_ratio = FMath::Clamp(FVector2D::Distance(
+			test_pt / ((float)morph_data.morph_res * 0.5f), FVector2D::ZeroVector), 0.0f, 1.0f);
 
-		float inv_center_ratio = 1.0f - center_ratio;
-		updatePoints(inv_center_ratio);
-		morph_data.play_center_anim_data.Get<1>() = manager_in->getRunTime();
+		morph_data.play_clips.Last().weight = 1.0f - center_ratio;
 	}
 
-	for (int32 i = 0; i < morph_data.play_anims_data.Num(); i++)
+	for (int32 i = 0; i < morph_data.morph_clips.Num(); i++)
 	{
-		auto& cur_data = morph_data.play_anims_data[i];
-		const auto& clip_name = cur_data.Get<0>();
-		manager_in->SetActiveAnimationName(clip_name);
-		manager_in->setRunTime(cur_data.Get<1>());
-		manager_in->Update(delta_step);
-
-		cur_data.Get<1>() = manager_in->getRunTime();
-		updatePoints((center_ratio > 0) ? (morph_data.weights[i] * center_ratio) : morph_data.weights[i]);
+		morph_data.play_clips[i].weight = (center_ratio > 0) ? (morph_data.weights[i] * center_ratio) : morph_data.weights[i];
 	}
 
-	// Copy to current render points
-	FMemory::Memcpy(
-		creature_in->GetRenderPts(),
-		morph_data.play_pts.GetData(), 
-		sizeof(glm::float32) * morph_data.play_pts.Num());
+	// All morph clips are blended in bone space and skinned once
+	manager_in->UpdateClips(delta_step, morph_data.play_clips, morph_data.play_run_times);
 }
 
 // Bend Physics
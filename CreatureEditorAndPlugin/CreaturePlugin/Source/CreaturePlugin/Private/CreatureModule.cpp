@@ -34,64 +34,69 @@
  *****************************************************************************/
 #include "CreatureModule.h"
 #include "CreaturePluginPCH.h"
+#include "CreatureBinaryFormat.h"
 #include <Runtime/Core/Public/Async/ParallelFor.h>
+#include "Async/MappedFileHandle.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Math/VectorRegister.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "zlib.h"
 
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_Update"), STAT_CreatureManager_Update, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_IncreRunTime"), STAT_CreatureManager_IncreRunTime, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_PoseJustBones"), STAT_CreatureManager_PoseJustBones, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_PoseCreature"), STAT_CreatureManager_PoseCreature, STATGROUP_Creature);
+DECLARE_CYCLE_STAT(TEXT("CreatureManager_PoseBlendGraph"), STAT_CreatureManager_PoseBlendGraph, STATGROUP_Creature);
+DECLARE_CYCLE_STAT(TEXT("CreatureManager_MakePointCache"), STAT_CreatureManager_MakePointCache, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_RunUVItemSwap"), STAT_CreatureManager_RunUVItemSwap, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_AlterBonesByAnchor"), STAT_CreatureManager_AlterBonesByAnchor, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("CreatureManager_JustRunUVWarps"), STAT_CreatureManager_JustRunUVWarps, STATGROUP_Creature);
 
+// Longest run of delta frames before the compressed point cache starts a new key frame
+static const int32 PointCacheKeyframeInterval = 16;
+
+// Longest span adaptive point cache sampling interpolates over
+static const int32 MaxAdaptiveCacheGap = 32;
+
 template <typename T>
 static T clipNum(const T& n, const T& lower, const T& upper) {
 	return FMath::Clamp(n, lower, upper);
 }
 
+// Keys are compared as raw strings, case insensitive like FName, so no name gets made per compared child
+static bool IsJSONKey(const JsonNode& json_node, const char * key)
+{
+    return (json_node.key != NULL) && (FCStringAnsi::Stricmp(json_node.key, key) == 0);
+}
+
 static JsonNode * GetJSONLevelNodeFromKey(JsonNode& json_obj,
-                                          const FName& key)
+                                          const char * key)
 {
-    JsonNode * ret_node = NULL;
-    if(FName(json_obj.key) == key) {
-        ret_node = &json_obj;
-    }
-    else {
-        JsonNode * cur_node = &json_obj;
-        while(true) {
-            if(FName(cur_node->key) == key) {
-                ret_node = cur_node;
-                break;
-            }
-            
-            JsonNode * next_node = cur_node->next;
-            if(next_node == NULL) {
-                break;
-            }
-            
-            cur_node = next_node;
+    for(JsonNode * cur_node = &json_obj; cur_node != NULL; cur_node = cur_node->next)
+    {
+        if(IsJSONKey(*cur_node, key)) {
+            return cur_node;
         }
     }
     
-    return ret_node;
+    return NULL;
 }
 
 static JsonNode * GetJSONNodeFromKey(JsonNode& json_obj,
-                                     const FName& key)
+                                     const char * key)
 {
-    JsonNode * ret_node = NULL;
-    
-    
     for(JsonIterator it = JsonBegin(json_obj.value);
         it != JsonEnd(json_obj.value); ++it)
     {
-        if( FName((*it)->key) == key) {
-            ret_node = *it;
-            break;
+        if(IsJSONKey(**it, key)) {
+            return *it;
         }
     }
     
-    return ret_node;
+    return NULL;
 }
 
 static TArray<FName> GetJSONKeysFromNode(JsonNode& json_obj)
@@ -133,7 +138,7 @@ static TArray<int32> GetJSONNodeIntArray(JsonNode& json_obj)
 }
 
 static glm::float32 * ReadJSONPoints3D(JsonNode& json_obj,
-                                       const FName& key,
+                                       const char * key,
                                        int32& num_pts)
 {
     TArray<float> pts_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
@@ -156,7 +161,7 @@ static glm::float32 * ReadJSONPoints3D(JsonNode& json_obj,
 }
 
 static glm::float32 * ReadJSONPoints2D(JsonNode& json_obj,
-                                       const FName& key,
+                                       const char * key,
                                        int32& num_pts)
 {
     TArray<float> pts_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
@@ -172,7 +177,7 @@ static glm::float32 * ReadJSONPoints2D(JsonNode& json_obj,
 }
 
 static TArray<glm::vec2> ReadJSONPoints2DVector(JsonNode& json_obj,
-                                                     const FName& key)
+                                                     const char * key)
 {
     TArray<float> pts_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
 	TArray<glm::vec2> ret_pts;
@@ -191,7 +196,7 @@ static TArray<glm::vec2> ReadJSONPoints2DVector(JsonNode& json_obj,
 }
 
 static glm::uint32 * ReadJSONUints(JsonNode& json_obj,
-                                   const FName& key,
+                                   const char * key,
                                    int32& num_ints)
 {
     TArray<int32> ints_array = GetJSONNodeIntArray(*GetJSONNodeFromKey(json_obj, key));
@@ -207,21 +212,21 @@ static glm::uint32 * ReadJSONUints(JsonNode& json_obj,
 }
 
 static glm::vec2 ReadJSONVec2(JsonNode& json_obj,
-                                const FName& key)
+                                const char * key)
 {
     TArray<float> read_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
     return glm::vec2(read_array[0], read_array[1]);
 }
 
 static glm::vec4 ReadJSONVec4_2(JsonNode& json_obj,
-                                const FName& key)
+                                const char * key)
 {
     TArray<float> read_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
     return glm::vec4(read_array[0], read_array[1], 0, 1.0f);
 }
 
 static glm::mat4 ReadJSONMat4(JsonNode& json_obj,
-                              const FName& key)
+                              const char * key)
 {
     TArray<float> read_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
     float mat_vals[16];
@@ -233,35 +238,13 @@ static glm::mat4 ReadJSONMat4(JsonNode& json_obj,
 }
 
 static TArray<int32> ReadIntArray(JsonNode& json_obj,
-                                     const FName& key)
-{
-    TArray<int32> read_array = GetJSONNodeIntArray(*GetJSONNodeFromKey(json_obj, key));;
-    TArray<int32> ret_array;
-    ret_array.SetNumZeroed(read_array.Num());
-    for(auto i = 0; i < read_array.Num(); i++)
-    {
-        ret_array[i] = read_array[i];
-    }
-    
-    return ret_array;
-}
-
-static TArray<float> ReadFloatArray(JsonNode& json_obj,
-                                     const FName& key)
+                                     const char * key)
 {
-    TArray<float> read_array = GetJSONNodeFloatArray(*GetJSONNodeFromKey(json_obj, key));
-    TArray<float> ret_array;
-    ret_array.SetNumZeroed(read_array.Num());
-    for(auto i = 0; i < read_array.Num(); i++)
-    {
-        ret_array[i] = read_array[i];
-    }
-    
-    return ret_array;
+    return GetJSONNodeIntArray(*GetJSONNodeFromKey(json_obj, key));
 }
 
 static meshBone * CreateBones(JsonNode& json_obj,
-                              const FName& key)
+                              const char * key)
 {
     meshBone * root_bone = NULL;
     JsonNode * base_obj =  GetJSONLevelNodeFromKey(json_obj, key);
@@ -326,7 +309,7 @@ static meshBone * CreateBones(JsonNode& json_obj,
 }
 
 static TArray<meshRenderRegion *> CreateRegions(JsonNode& json_obj,
-                                                     const FName& key,
+                                                     const char * key,
                                                      glm::uint32 * indices_in,
                                                      glm::float32 * rest_pts_in,
                                                      glm::float32 * uvs_in)
@@ -368,11 +351,9 @@ static TArray<meshRenderRegion *> CreateRegions(JsonNode& json_obj,
              w_it != JsonEnd(weight_obj->value);
              ++w_it)
         {
+            // The iterated node already holds the values, no need to look its key up again
             JsonNode * w_node = *w_it;
-            
-            FName cur_key(w_node->key);
-            TArray<float> values = ReadFloatArray(*weight_obj, cur_key);
-            weight_map.Add(cur_key, values);
+            weight_map.Add(FName(w_node->key), GetJSONNodeFloatArray(*w_node));
         }
         
         ret_regions.Add(new_region);
@@ -382,7 +363,7 @@ static TArray<meshRenderRegion *> CreateRegions(JsonNode& json_obj,
 }
 
 static std::pair<int32, int32> GetStartEndTimes(JsonNode& json_obj,
-                                            const FName& key)
+                                            const char * key)
 {
     std::pair<int32, int32> ret_times(0,0);
     bool first = true;
@@ -415,7 +396,7 @@ static std::pair<int32, int32> GetStartEndTimes(JsonNode& json_obj,
 }
 
 static void FillBoneCache(JsonNode& json_obj,
-                          const FName& key,
+                          const char * key,
                           int32 start_time,
                           int32 end_time,
                           meshBoneCacheManager& cache_manager)
@@ -424,7 +405,6 @@ static void FillBoneCache(JsonNode& json_obj,
 
     cache_manager.init(start_time, end_time);
     
-	int32 prev_time = start_time;
     for (JsonIterator it = JsonBegin(base_obj->value);
          it != JsonEnd(base_obj->value);
          ++it)
@@ -453,47 +433,14 @@ static void FillBoneCache(JsonNode& json_obj,
         
         int32 set_index = cache_manager.getIndexByTime(cur_time);
         cache_manager.getCacheTable()[set_index] = cache_list;
-
-		int32 gap_diff = cur_time - prev_time;
-		if (gap_diff > 1)
-		{
-			auto ptInterp = [&](const glm::vec4& src_pt, const glm::vec4& target_pt, float fraction)
-			{
-				return ((1.0f - fraction) * src_pt) + (fraction * target_pt);
-			};
-
-			// Gap Step
-			auto prev_index = cache_manager.getIndexByTime(prev_time);
-			for (int32 j = 1; j < gap_diff; j++)
-			{
-				auto gap_fraction = (float)j / (float)gap_diff;
-				TArray<meshBoneCache> gap_cache_list;
-				
-				for (int32 k = 0; k < cache_list.Num(); k++)
-				{
-					auto& cur_data = cache_manager.getCacheTable()[set_index][k];
-					auto& prev_data = cache_manager.getCacheTable()[prev_index][k];
-					meshBoneCache gap_cache_data(cur_data.getKey());
-					gap_cache_data.setWorldStartPt(
-						ptInterp(prev_data.getWorldStartPt(), cur_data.getWorldStartPt(), gap_fraction));
-					gap_cache_data.setWorldEndPt(
-						ptInterp(prev_data.getWorldEndPt(), cur_data.getWorldEndPt(), gap_fraction));
-
-					gap_cache_list.Add(gap_cache_data);
-				}
-
-				cache_manager.getCacheTable()[prev_index + j] = gap_cache_list;
-			}
-		}
-
-		prev_time = cur_time;
 	}
     
+    // Frames between the exported keys are interpolated when retrieved
     cache_manager.makeAllReady();
 }
 
 static void FillDeformationCache(JsonNode& json_obj,
-                          const FName& key,
+                          const char * key,
                           int32 start_time,
                           int32 end_time,
                           meshDisplacementCacheManager& cache_manager)
@@ -502,7 +449,6 @@ static void FillDeformationCache(JsonNode& json_obj,
 
     cache_manager.init(start_time, end_time);
     
-	int prev_time = start_time;
 	for (JsonIterator it = JsonBegin(base_obj->value);
          it != JsonEnd(base_obj->value);
          ++it)
@@ -540,60 +486,15 @@ static void FillDeformationCache(JsonNode& json_obj,
         
         int32 set_index = cache_manager.getIndexByTime(cur_time);
         cache_manager.getCacheTable()[set_index] = cache_list;
-
-		auto gap_diff = cur_time - prev_time;
-		if (gap_diff > 1)
-		{
-			auto ptsInterp = [&](const TArray<glm::vec2> src_pts, const TArray<glm::vec2> target_pts, float fraction)
-			{
-				TArray<glm::vec2> ret_pts;
-				ret_pts.SetNum(src_pts.Num());
-				for (int32 i = 0; i < src_pts.Num(); i++)
-				{
-					ret_pts[i] = ((1.0f - fraction) * src_pts[i]) + (fraction * target_pts[i]);
-				}
-
-				return ret_pts;
-			};
-
-			// Gap Step
-			int32 prev_index = cache_manager.getIndexByTime(prev_time);
-			for (int32 j = 1; j < gap_diff; j++)
-			{
-				auto gap_fraction = (float)j / (float)gap_diff;
-				TArray<meshDisplacementCache> gap_cache_list;
-				
-				for (int32 k = 0; k < cache_list.Num(); k++)
-				{
-					auto& cur_data = cache_manager.getCacheTable()[set_index][k];
-					auto& prev_data = cache_manager.getCacheTable()[prev_index][k];
-					meshDisplacementCache gap_cache_data(cur_data.getKey());
-					if (cur_data.getLocalDisplacements().Num() > 0)
-					{
-						gap_cache_data.setLocalDisplacements(
-							ptsInterp(prev_data.getLocalDisplacements(), cur_data.getLocalDisplacements(), gap_fraction));
-					}
-					else {
-						gap_cache_data.setPostDisplacements(
-							ptsInterp(prev_data.getPostDisplacements(), cur_data.getPostDisplacements(), gap_fraction));
-					}
-
-					gap_cache_list.Add(gap_cache_data);
-				}
-
-				cache_manager.getCacheTable()[prev_index + j] = gap_cache_list;
-			}
-		}
-
-		prev_time = cur_time;
     }
     
+    // Frames between the exported keys are interpolated when retrieved
     cache_manager.makeAllReady();
 }
 
 
 static void FillUVSwapCache(JsonNode& json_obj,
-                            const FName& key,
+                            const char * key,
                             int32 start_time,
                             int32 end_time,
                             meshUVWarpCacheManager& cache_manager)
@@ -642,7 +543,7 @@ static void FillUVSwapCache(JsonNode& json_obj,
 }
 
 static void FillOpacityCache(JsonNode& json_obj,
-	const FName& key,
+	const char * key,
 	int32 start_time,
 	int32 end_time,
 	meshOpacityCacheManager& cache_manager)
@@ -656,7 +557,6 @@ static void FillOpacityCache(JsonNode& json_obj,
 		return;
 	}
 
-	int prev_time = start_time;
 	for (JsonIterator it = JsonBegin(base_obj->value);
 		it != JsonEnd(base_obj->value);
 		++it)
@@ -683,39 +583,9 @@ static void FillOpacityCache(JsonNode& json_obj,
 
 		int32 set_index = cache_manager.getIndexByTime(cur_time);
 		cache_manager.getCacheTable()[set_index] = cache_list;
-
-		int32 gap_diff = cur_time - prev_time;
-		if (gap_diff > 1)
-		{
-			auto scalarInterp = [&](const float& src_val, const float& target_val, float fraction)
-			{
-				return ((1.0f - fraction) * src_val) + (fraction * target_val);
-			};
-
-			// Gap Step
-			int32 prev_index = cache_manager.getIndexByTime(prev_time);
-			for (int32 j = 1; j < gap_diff; j++)
-			{
-				auto gap_fraction = (float)j / (float)gap_diff;
-				TArray<meshOpacityCache> gap_cache_list;
-				
-				for (int32 k = 0; k < cache_list.Num(); k++)
-				{
-					auto& cur_data = cache_manager.getCacheTable()[set_index][k];
-					auto& prev_data = cache_manager.getCacheTable()[prev_index][k];
-					meshOpacityCache gap_cache_data(cur_data.getKey());
-					gap_cache_data.setOpacity(scalarInterp(prev_data.getOpacity(), cur_data.getOpacity(), gap_fraction));
-
-					gap_cache_list.Add(gap_cache_data);
-				}
-
-				cache_manager.getCacheTable()[prev_index + j] = gap_cache_list;
-			}
-		}
-
-		prev_time = cur_time;
 	}
 
+	// Frames between the exported keys are interpolated when retrieved
 	cache_manager.makeAllReady();
 
 }
@@ -772,149 +642,1321 @@ FillAnchorPointMap(JsonNode& json_obj)
 	return ret_map;
 }
 
+// Compiled binary helpers
+using namespace CreatureModule::CreatureBinary;
 
-namespace CreatureModule {
-    // Load the json structure
-    void LoadCreatureJSONData(const FName& filename_in,
-                              CreatureLoadDataPacket& load_data)
+static_assert(MaxInfluences == meshRenderRegionWeights::max_influences, "Binary influence table width has to match the runtime one");
+
+template <typename T>
+static const T * GetBinaryBlock(const CreatureModule::CreatureLoadDataPacket& load_data,
+                                uint32 offset)
+{
+    return reinterpret_cast<const T *>(load_data.binary_data + offset);
+}
+
+static const FileHeader& GetBinaryHeader(const CreatureModule::CreatureLoadDataPacket& load_data)
+{
+    return *GetBinaryBlock<FileHeader>(load_data, 0);
+}
+
+static bool IsBinaryRangeValid(const FileHeader& header, uint32 offset, int64 num_bytes)
+{
+    return (num_bytes >= 0) && ((int64)offset + num_bytes <= (int64)header.total_size);
+}
+
+static bool ValidateBinaryData(const uint8 * data_in, int64 size_in)
+{
+    if((data_in == NULL) || (size_in < (int64)sizeof(FileHeader))) {
+        return false;
+    }
+    
+    const FileHeader& header = *reinterpret_cast<const FileHeader *>(data_in);
+    if((header.magic != Magic)
+       || (header.version != Version)
+       || (header.header_size != sizeof(FileHeader))
+       || ((int64)header.total_size > size_in))
     {
-        std::ifstream read_file;
-        read_file.open(TCHAR_TO_UTF8(*filename_in.ToString()));
-        std::stringstream str_stream;
-        str_stream << read_file.rdbuf();
-        read_file.close();
-        
-        LoadCreatureJSONDataFromString(str_stream.str().c_str(), load_data);
+        return false;
     }
     
-    void LoadCreatureJSONDataFromString(const FString& string_in,
-                                        CreatureLoadDataPacket& load_data)
+    return IsBinaryRangeValid(header, header.names_offset, (int64)header.num_names * sizeof(NameEntry))
+        && IsBinaryRangeValid(header, header.points_offset, (int64)header.num_pts * 3 * sizeof(float))
+        && IsBinaryRangeValid(header, header.indices_offset, (int64)header.num_indices * sizeof(uint32))
+        && IsBinaryRangeValid(header, header.uvs_offset, (int64)header.num_pts * 2 * sizeof(float))
+        && IsBinaryRangeValid(header, header.bones_offset, (int64)header.num_bones * sizeof(BoneEntry))
+        && IsBinaryRangeValid(header, header.regions_offset, (int64)header.num_regions * sizeof(RegionEntry))
+        && IsBinaryRangeValid(header, header.animation_names_offset, (int64)header.num_animation_names * sizeof(int32))
+        && IsBinaryRangeValid(header, header.uv_swap_items_offset, (int64)header.num_uv_swap_items * sizeof(UVSwapEntry))
+        && IsBinaryRangeValid(header, header.anchor_points_offset, (int64)header.num_anchor_points * sizeof(AnchorPointEntry))
+        && IsBinaryRangeValid(header, header.clips_offset, (int64)header.num_clips * sizeof(ClipEntry))
+        && (header.num_bones > 0);
+}
+
+// Whether num elements of elem_size bytes, starting first elements past offset, lie inside the data
+static bool IsBinaryArrayValid(const FileHeader& header, uint32 offset, int64 first, int64 num, int64 elem_size)
+{
+    return (first >= 0) && (num >= 0) && ((int64)offset + ((first + num) * elem_size) <= (int64)header.total_size);
+}
+
+static bool IsBinaryNameValid(const FileHeader& header, int32 name_idx)
+{
+    return (name_idx >= 0) && (name_idx < header.num_names);
+}
+
+// Checks the per frame key ranges of one key array of a clip, and the name of every key in them
+template <typename T>
+static bool ValidateBinaryFrameKeys(const CreatureModule::CreatureLoadDataPacket& load_data,
+                                    const ClipEntry& clip,
+                                    uint32 frames_offset,
+                                    uint32 keys_offset)
+{
+    const FileHeader& header = GetBinaryHeader(load_data);
+    const int32 num_frames = GetNumFrames(clip);
+    if(IsBinaryArrayValid(header, frames_offset, 0, num_frames, sizeof(FrameEntry)) == false) {
+        return false;
+    }
+    
+    const FrameEntry * frames = GetBinaryBlock<FrameEntry>(load_data, frames_offset);
+    for(int32 i = 0; i < num_frames; i++)
     {
-        char *endptr;
-        size_t source_size = string_in.Len();
-        char *source_chars = new char[source_size+1];
-        source_chars[source_size]=0;
-        memcpy(source_chars, TCHAR_TO_UTF8(*string_in), source_size);
-        
-        JsonParseStatus status = jsonParse(source_chars, &endptr, &load_data.base_node, load_data.allocator);
-        
-        load_data.src_chars = source_chars;
+        if(IsBinaryArrayValid(header, keys_offset, frames[i].first_key, frames[i].num_keys, sizeof(T)) == false) {
+            return false;
+        }
         
-        if(status != JSON_PARSE_OK) {
-            std::cerr<<"LoadCreatureJSONData() - Error parsing JSON!"<<std::endl;
+        const T * keys = GetBinaryBlock<T>(load_data, keys_offset) + frames[i].first_key;
+        for(uint32 j = 0; j < frames[i].num_keys; j++)
+        {
+            if(IsBinaryNameValid(header, keys[j].name_idx) == false) {
+                return false;
+            }
         }
     }
     
-    void LoadCreatureZipJSONData(const FName& filename_in,
-                                 CreatureLoadDataPacket& load_data)
+    return true;
+}
+
+static bool ValidateBinaryClip(const CreatureModule::CreatureLoadDataPacket& load_data, const ClipEntry& clip)
+{
+    const FileHeader& header = GetBinaryHeader(load_data);
+    if((IsBinaryNameValid(header, clip.name_idx) == false)
+       || (clip.end_time < clip.start_time)
+       || (((int64)clip.end_time - clip.start_time) >= (int64)header.total_size))
     {
-		std::cout << "LoadCreatureZipJSONData() - Function is NOT DEFINED!" << std::endl;
+        return false;
     }
-
-    // Creature class
-    Creature::Creature(CreatureLoadDataPacket& load_data)
+    
+    const int32 num_frames = GetNumFrames(clip);
+    if(clip.flags & ClipHasCompressedBones)
     {
-		anchor_points_active = false;
-        LoadFromData(load_data);
+        if(IsBinaryArrayValid(header, clip.bone_tracks_offset, 0, clip.num_bone_tracks, sizeof(BoneTrackEntry)) == false) {
+            return false;
+        }
+        
+        const BoneTrackEntry * track_entries = GetBinaryBlock<BoneTrackEntry>(load_data, clip.bone_tracks_offset);
+        int64 num_track_keys = 0;
+        for(int32 i = 0; i < clip.num_bone_tracks; i++)
+        {
+            const BoneTrackEntry& cur_entry = track_entries[i];
+            if((IsBinaryNameValid(header, cur_entry.name_idx) == false)
+               || (cur_entry.first_key < 0)
+               || (cur_entry.num_keys < 0))
+            {
+                return false;
+            }
+            
+            num_track_keys = FMath::Max(num_track_keys, (int64)cur_entry.first_key + cur_entry.num_keys);
+        }
+        
+        if((IsBinaryArrayValid(header, clip.bone_track_frames_offset, 0, num_track_keys, sizeof(uint16)) == false)
+           || (IsBinaryArrayValid(header, clip.bone_track_values_offset, 0, num_track_keys * 4, sizeof(uint16)) == false))
+        {
+            return false;
+        }
+    }
+    else if(ValidateBinaryFrameKeys<BoneKey>(load_data, clip, clip.bone_frames_offset, clip.bone_keys_offset) == false) {
+        return false;
     }
     
-    Creature::~Creature()
+    if(clip.flags & ClipHasDisplacementBasis)
     {
-        delete [] global_pts;
-        delete [] global_indices;
-        delete [] global_uvs;
-        delete [] render_colours;
-        delete render_composition;
-        delete [] render_pts;
-
-		global_pts = nullptr;
-		global_indices = nullptr;
-		global_uvs = nullptr;
-		render_composition = nullptr;
-		render_pts = nullptr;
+        if((IsBinaryArrayValid(header, clip.displacement_tracks_offset, 0, clip.num_displacement_tracks, sizeof(DisplacementTrackEntry)) == false)
+           || (IsBinaryArrayValid(header, clip.displacement_key_frames_offset, 0, clip.num_displacement_key_frames, sizeof(int32)) == false))
+        {
+            return false;
+        }
+        
+        const int32 * key_frames = GetBinaryBlock<int32>(load_data, clip.displacement_key_frames_offset);
+        for(int32 i = 0; i < clip.num_displacement_key_frames; i++)
+        {
+            if((key_frames[i] < 0) || (key_frames[i] >= num_frames)) {
+                return false;
+            }
+        }
+        
+        const DisplacementTrackEntry * track_entries =
+            GetBinaryBlock<DisplacementTrackEntry>(load_data, clip.displacement_tracks_offset);
+        int64 num_basis_values = 0;
+        int64 num_basis_coeffs = 0;
+        for(int32 i = 0; i < clip.num_displacement_tracks; i++)
+        {
+            const DisplacementTrackEntry& cur_entry = track_entries[i];
+            if((IsBinaryNameValid(header, cur_entry.name_idx) == false)
+               || (cur_entry.num_local_pts < 0)
+               || (cur_entry.num_post_pts < 0)
+               || (cur_entry.num_basis < 0)
+               || (cur_entry.basis_offset < 0)
+               || (cur_entry.coeffs_offset < 0))
+            {
+                return false;
+            }
+            
+            const int64 num_vals = ((int64)cur_entry.num_local_pts + cur_entry.num_post_pts) * 2;
+            num_basis_values = FMath::Max(num_basis_values, cur_entry.basis_offset + (((int64)cur_entry.num_basis + 1) * num_vals));
+            num_basis_coeffs = FMath::Max(num_basis_coeffs, cur_entry.coeffs_offset + ((int64)cur_entry.num_basis * clip.num_displacement_key_frames));
+        }
+        
+        if((IsBinaryArrayValid(header, clip.displacement_basis_offset, 0, num_basis_values, sizeof(float)) == false)
+           || (IsBinaryArrayValid(header, clip.displacement_coeffs_offset, 0, num_basis_coeffs, sizeof(float)) == false))
+        {
+            return false;
+        }
+    }
+    else {
+        if(ValidateBinaryFrameKeys<DisplacementKey>(load_data, clip, clip.displacement_frames_offset, clip.displacement_keys_offset) == false) {
+            return false;
+        }
+        
+        const FrameEntry * frames = GetBinaryBlock<FrameEntry>(load_data, clip.displacement_frames_offset);
+        const DisplacementKey * keys = GetBinaryBlock<DisplacementKey>(load_data, clip.displacement_keys_offset);
+        for(int32 i = 0; i < num_frames; i++)
+        {
+            for(uint32 j = 0; j < frames[i].num_keys; j++)
+            {
+                const DisplacementKey& cur_key = keys[frames[i].first_key + j];
+                if((cur_key.num_local_pts < 0)
+                   || (cur_key.num_post_pts < 0)
+                   || (IsBinaryArrayValid(header, cur_key.pts_offset, 0, ((int64)cur_key.num_local_pts + cur_key.num_post_pts) * 2, sizeof(float)) == false))
+                {
+                    return false;
+                }
+            }
+        }
     }
     
-    glm::uint32 *
-    Creature::GetGlobalIndices()
+    if(ValidateBinaryFrameKeys<UVWarpKey>(load_data, clip, clip.uv_frames_offset, clip.uv_keys_offset) == false) {
+        return false;
+    }
+    
+    return ((clip.flags & ClipHasOpacity) == 0)
+        || ValidateBinaryFrameKeys<OpacityKey>(load_data, clip, clip.opacity_frames_offset, clip.opacity_keys_offset);
+}
+
+// Checks every index and offset stored in the tables, ValidateBinaryData only covers the header blocks
+static bool ValidateBinaryTables(const CreatureModule::CreatureLoadDataPacket& load_data)
+{
+    const FileHeader& header = GetBinaryHeader(load_data);
+    
+    const uint32 * indices = GetBinaryBlock<uint32>(load_data, header.indices_offset);
+    for(int32 i = 0; i < header.num_indices; i++)
     {
-        return global_indices;
+        if(indices[i] >= (uint32)header.num_pts) {
+            return false;
+        }
     }
     
-    glm::float32 *
-    Creature::GetGlobalPts()
+    // Bones are built in order, so a parent has to be an earlier slot and only the first bone is a root
+    const BoneEntry * bone_entries = GetBinaryBlock<BoneEntry>(load_data, header.bones_offset);
+    for(int32 i = 0; i < header.num_bones; i++)
     {
-        return global_pts;
+        const BoneEntry& cur_entry = bone_entries[i];
+        const bool parent_valid = (i == 0) ? (cur_entry.parent_slot < 0) : ((cur_entry.parent_slot >= 0) && (cur_entry.parent_slot < i));
+        if((IsBinaryNameValid(header, cur_entry.name_idx) == false) || (parent_valid == false)) {
+            return false;
+        }
     }
     
-    glm::float32 *
-    Creature::GetGlobalUvs()
+    const RegionEntry * region_entries = GetBinaryBlock<RegionEntry>(load_data, header.regions_offset);
+    for(int32 i = 0; i < header.num_regions; i++)
     {
-        return global_uvs;
+        const RegionEntry& cur_entry = region_entries[i];
+        if((IsBinaryNameValid(header, cur_entry.name_idx) == false)
+           || (cur_entry.start_pt_index < 0)
+           || (cur_entry.start_pt_index > cur_entry.end_pt_index)
+           || (cur_entry.end_pt_index >= header.num_pts)
+           || (cur_entry.start_index < 0)
+           || (cur_entry.start_index > cur_entry.end_index)
+           || (cur_entry.end_index >= header.num_indices))
+        {
+            return false;
+        }
+        
+        const int64 region_num_pts = (int64)cur_entry.end_pt_index - cur_entry.start_pt_index + 1;
+        if((cur_entry.num_influence_bones > MAX_uint16)
+           || (IsBinaryArrayValid(header, cur_entry.influence_bones_offset, 0, cur_entry.num_influence_bones, sizeof(int32)) == false)
+           || (IsBinaryArrayValid(header, cur_entry.influences_offset, 0, region_num_pts * MaxInfluences, sizeof(InfluenceEntry)) == false)
+           || (IsBinaryArrayValid(header, cur_entry.influence_counts_offset, 0, region_num_pts, sizeof(uint8)) == false))
+        {
+            return false;
+        }
+        
+        // Influence bones have to be bones of the character
+        const int32 * influence_bones = GetBinaryBlock<int32>(load_data, cur_entry.influence_bones_offset);
+        for(int32 j = 0; j < cur_entry.num_influence_bones; j++)
+        {
+            bool is_bone = false;
+            for(int32 k = 0; (k < header.num_bones) && !is_bone; k++)
+            {
+                is_bone = (bone_entries[k].name_idx == influence_bones[j]);
+            }
+            
+            if(is_bone == false) {
+                return false;
+            }
+        }
+        
+        const InfluenceEntry * influences = GetBinaryBlock<InfluenceEntry>(load_data, cur_entry.influences_offset);
+        const uint8 * influence_counts = GetBinaryBlock<uint8>(load_data, cur_entry.influence_counts_offset);
+        for(int64 j = 0; j < region_num_pts; j++)
+        {
+            if(influence_counts[j] > MaxInfluences) {
+                return false;
+            }
+            
+            for(int32 k = 0; k < influence_counts[j]; k++)
+            {
+                if(influences[(j * MaxInfluences) + k].bone_index >= cur_entry.num_influence_bones) {
+                    return false;
+                }
+            }
+        }
     }
     
-    glm::float32 *
-    Creature::GetRenderPts()
+    const int32 * animation_name_indices = GetBinaryBlock<int32>(load_data, header.animation_names_offset);
+    for(int32 i = 0; i < header.num_animation_names; i++)
     {
-        return render_pts;
+        if(IsBinaryNameValid(header, animation_name_indices[i]) == false) {
+            return false;
+        }
     }
     
-    glm::uint8 *
-    Creature::GetRenderColours()
+    const UVSwapEntry * uv_swap_entries = GetBinaryBlock<UVSwapEntry>(load_data, header.uv_swap_items_offset);
+    for(int32 i = 0; i < header.num_uv_swap_items; i++)
     {
-        return render_colours;
+        if(IsBinaryNameValid(header, uv_swap_entries[i].region_name_idx) == false) {
+            return false;
+        }
     }
     
-    int32
-    Creature::GetTotalNumPoints() const
+    const AnchorPointEntry * anchor_entries = GetBinaryBlock<AnchorPointEntry>(load_data, header.anchor_points_offset);
+    for(int32 i = 0; i < header.num_anchor_points; i++)
     {
-        return total_num_pts;
+        if(IsBinaryNameValid(header, anchor_entries[i].clip_name_idx) == false) {
+            return false;
+        }
     }
     
-    int32
-    Creature::GetTotalNumIndices() const
+    const ClipEntry * clips = GetBinaryBlock<ClipEntry>(load_data, header.clips_offset);
+    for(int32 i = 0; i < header.num_clips; i++)
     {
-        return total_num_indices;
+        if(ValidateBinaryClip(load_data, clips[i]) == false) {
+            return false;
+        }
     }
     
-    meshRenderBoneComposition *
-    Creature::GetRenderComposition()
+    return true;
+}
+
+// Validates the binary data held by the packet and resolves its name table
+static bool PrepareBinaryPacket(CreatureModule::CreatureLoadDataPacket& load_data)
+{
+    if((ValidateBinaryData(load_data.binary_data, load_data.binary_size) == false)
+       || (ValidateBinaryTables(load_data) == false))
     {
-        return render_composition;
+        UE_LOG(LogTemp, Warning, TEXT("CreatureModule - Invalid or outdated compiled creature binary data!"));
+        load_data.binary_data = NULL;
+        load_data.binary_size = 0;
+        return false;
     }
     
-    void
-    Creature::FillRenderColours(glm::uint8 r, glm::uint8 g, glm::uint8 b, glm::uint8 a)
+    const FileHeader& header = GetBinaryHeader(load_data);
+    const NameEntry * names = GetBinaryBlock<NameEntry>(load_data, header.names_offset);
+    load_data.binary_names.Reset(header.num_names);
+    for(int32 i = 0; i < header.num_names; i++)
     {
-        for(auto i = 0; i < total_num_pts; i++)
+        if(IsBinaryRangeValid(header, names[i].chars_offset, names[i].num_chars) == false)
         {
-            glm::uint8 * cur_colour = render_colours + (i * 4);
-            cur_colour[0] = r;
-            cur_colour[1] = g;
-            cur_colour[2] = b;
-            cur_colour[3] = a;
+            UE_LOG(LogTemp, Warning, TEXT("CreatureModule - Corrupt name table in compiled creature binary data!"));
+            load_data.binary_data = NULL;
+            load_data.binary_size = 0;
+            return false;
         }
+        
+        const ANSICHAR * name_chars = GetBinaryBlock<ANSICHAR>(load_data, names[i].chars_offset);
+        FUTF8ToTCHAR name_conv(name_chars, names[i].num_chars);
+        load_data.binary_names.Add(FName(name_conv.Length(), name_conv.Get()));
     }
+    
+    return true;
+}
 
-    const TArray<FName>& 
-    Creature::GetAnimationNames() const
+static const ClipEntry * FindBinaryClip(const CreatureModule::CreatureLoadDataPacket& load_data,
+                                        const FName& name_in)
+{
+    const FileHeader& header = GetBinaryHeader(load_data);
+    const ClipEntry * clips = GetBinaryBlock<ClipEntry>(load_data, header.clips_offset);
+    for(int32 i = 0; i < header.num_clips; i++)
     {
-        return animation_names;
+        if(load_data.binary_names[clips[i].name_idx] == name_in) {
+            return &clips[i];
+        }
     }
+    
+    return NULL;
+}
 
-	const TMap<FName, TArray<CreatureUVSwapPacket> >& 
-	Creature::GetUvSwapPackets() const
-	{
-		return uv_swap_packets;
-	}
-
-	void 
-	Creature::SetActiveItemSwap(const FName& region_name, int32 swap_idx)
-	{
-		active_uv_swap_actions.Add(region_name, swap_idx);
-	}
-
-	void 
-	Creature::RemoveActiveItemSwap(const FName& region_name)
+// Writes out 16 byte aligned blocks for the compiled binary format
+class CreatureBinaryWriter {
+public:
+    CreatureBinaryWriter(TArray<uint8>& data_in)
+    : data(data_in)
+    {}
+    
+    uint32 Reserve(int64 num_bytes)
+    {
+        Align();
+        uint32 offset = (uint32)data.Num();
+        data.AddZeroed(num_bytes);
+        return offset;
+    }
+    
+    template <typename T>
+    uint32 Write(const T * values, int32 num_values)
+    {
+        uint32 offset = Reserve((int64)sizeof(T) * num_values);
+        if(num_values > 0) {
+            FMemory::Memcpy(data.GetData() + offset, values, sizeof(T) * num_values);
+        }
+        
+        return offset;
+    }
+    
+    template <typename T>
+    void Overwrite(uint32 offset, const T& value)
+    {
+        FMemory::Memcpy(data.GetData() + offset, &value, sizeof(T));
+    }
+    
+    int32 AddName(const FName& name_in)
+    {
+        if(const int32 * found_idx = name_indices.Find(name_in)) {
+            return *found_idx;
+        }
+        
+        int32 new_idx = names.Add(name_in);
+        name_indices.Add(name_in, new_idx);
+        return new_idx;
+    }
+    
+    uint32 WriteNames()
+    {
+        TArray<NameEntry> entries;
+        entries.SetNumZeroed(names.Num());
+        for(int32 i = 0; i < names.Num(); i++)
+        {
+            FTCHARToUTF8 name_conv(*names[i].ToString());
+            entries[i].chars_offset = Write((const uint8 *)name_conv.Get(), name_conv.Length());
+            entries[i].num_chars = (uint32)name_conv.Length();
+        }
+        
+        return Write(entries.GetData(), entries.Num());
+    }
+    
+    int32 GetNumNames() const
+    {
+        return names.Num();
+    }
+    
+    void Align()
+    {
+        int32 aligned_num = ::Align((int32)data.Num(), (int32)Alignment);
+        data.AddZeroed(aligned_num - data.Num());
+    }
+    
+protected:
+    TArray<uint8>& data;
+    TArray<FName> names;
+    TMap<FName, int32> name_indices;
+};
+
+template <typename CacheType, typename KeyType, typename FillFunc>
+static uint32 WriteBinaryTrack(CreatureBinaryWriter& writer,
+                               TArray<TArray<CacheType> >& cache_table,
+                               const TArray<int32>& key_frames,
+                               int32 num_frames,
+                               FillFunc fill_func,
+                               uint32& keys_offset_out)
+{
+    // One row per stored key, frames between keys are left empty
+    TArray<FrameEntry> frames;
+    TArray<KeyType> keys;
+    frames.SetNumZeroed(num_frames);
+    
+    for(int32 i = 0; i < cache_table.Num(); i++)
+    {
+        FrameEntry& cur_frame = frames[key_frames[i]];
+        cur_frame.first_key = (uint32)keys.Num();
+        cur_frame.num_keys = (uint32)cache_table[i].Num();
+        for(auto& cur_cache : cache_table[i])
+        {
+            KeyType new_key;
+            FMemory::Memzero(new_key);
+            new_key.name_idx = writer.AddName(cur_cache.getKey());
+            fill_func(cur_cache, new_key);
+            keys.Add(new_key);
+        }
+    }
+    
+    keys_offset_out = writer.Write(keys.GetData(), keys.Num());
+    return writer.Write(frames.GetData(), frames.Num());
+}
+
+
+// Zip archive entry, only what is needed to pull out the packed json
+struct ZipEntryInfo
+{
+    uint16 method;
+    uint32 compressed_size;
+    uint32 uncompressed_size;
+    int64 data_offset;
+};
+
+static const uint32 ZipLocalHeaderSig = 0x04034b50;
+static const uint32 ZipCentralHeaderSig = 0x02014b50;
+static const uint32 ZipEndRecordSig = 0x06054b50;
+static const int32 ZipLocalHeaderSize = 30;
+static const int32 ZipCentralHeaderSize = 46;
+static const int32 ZipEndRecordSize = 22;
+static const int32 ZipReadChunkSize = 64 * 1024;
+
+static uint16 ReadZipUint16(const uint8 * data_in)
+{
+    return (uint16)(data_in[0] | (data_in[1] << 8));
+}
+
+static uint32 ReadZipUint32(const uint8 * data_in)
+{
+    return (uint32)data_in[0] | ((uint32)data_in[1] << 8) | ((uint32)data_in[2] << 16) | ((uint32)data_in[3] << 24);
+}
+
+// Finds the first entry of a zip archive. Sizes are read from the central directory since
+// the local header can leave them to a data descriptor after the data.
+static bool FindFirstZipEntry(IFileHandle& file_in, ZipEntryInfo& entry_out)
+{
+    const int64 file_size = file_in.Size();
+    if(file_size < ZipEndRecordSize)
+    {
+        return false;
+    }
+    
+    // The end record sits at the end of the file, only followed by a comment of up to 64k
+    const int64 tail_size = FMath::Min(file_size, (int64)(ZipEndRecordSize + MAX_uint16));
+    TArray<uint8> tail_data;
+    tail_data.SetNumUninitialized(tail_size);
+    if(!file_in.Seek(file_size - tail_size) || !file_in.Read(tail_data.GetData(), tail_size))
+    {
+        return false;
+    }
+    
+    int32 end_record_idx = INDEX_NONE;
+    for(int32 i = tail_size - ZipEndRecordSize; i >= 0; i--)
+    {
+        if(ReadZipUint32(tail_data.GetData() + i) == ZipEndRecordSig)
+        {
+            end_record_idx = i;
+            break;
+        }
+    }
+    
+    if((end_record_idx == INDEX_NONE) || (ReadZipUint16(tail_data.GetData() + end_record_idx + 10) == 0))
+    {
+        return false;
+    }
+    
+    const uint32 central_offset = ReadZipUint32(tail_data.GetData() + end_record_idx + 16);
+    uint8 central_header[ZipCentralHeaderSize];
+    if(!file_in.Seek(central_offset)
+       || !file_in.Read(central_header, ZipCentralHeaderSize)
+       || (ReadZipUint32(central_header) != ZipCentralHeaderSig))
+    {
+        return false;
+    }
+    
+    entry_out.method = ReadZipUint16(central_header + 10);
+    entry_out.compressed_size = ReadZipUint32(central_header + 20);
+    entry_out.uncompressed_size = ReadZipUint32(central_header + 24);
+    const uint32 local_offset = ReadZipUint32(central_header + 42);
+    if((entry_out.compressed_size == MAX_uint32) || (entry_out.uncompressed_size == MAX_uint32))
+    {
+        // zip64 archives are not supported
+        return false;
+    }
+    
+    uint8 local_header[ZipLocalHeaderSize];
+    if(!file_in.Seek(local_offset)
+       || !file_in.Read(local_header, ZipLocalHeaderSize)
+       || (ReadZipUint32(local_header) != ZipLocalHeaderSig))
+    {
+        return false;
+    }
+    
+    entry_out.data_offset = (int64)local_offset + ZipLocalHeaderSize
+        + ReadZipUint16(local_header + 26) + ReadZipUint16(local_header + 28);
+    
+    return true;
+}
+
+// Inflates a deflated zip entry chunk by chunk straight into chars_out
+static bool InflateZipEntry(IFileHandle& file_in, const ZipEntryInfo& entry_in, uint8 * chars_out)
+{
+    if(!file_in.Seek(entry_in.data_offset))
+    {
+        return false;
+    }
+    
+    z_stream stream;
+    FMemory::Memzero(stream);
+    
+    // zip entries are raw deflate streams without the zlib header
+    if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+    {
+        return false;
+    }
+    
+    stream.next_out = chars_out;
+    stream.avail_out = entry_in.uncompressed_size;
+    
+    TArray<uint8> read_chunk;
+    read_chunk.SetNumUninitialized(ZipReadChunkSize);
+    int64 remaining_size = entry_in.compressed_size;
+    int32 status = Z_OK;
+    while((status == Z_OK) && (remaining_size > 0))
+    {
+        const int32 chunk_size = (int32)FMath::Min(remaining_size, (int64)ZipReadChunkSize);
+        if(!file_in.Read(read_chunk.GetData(), chunk_size))
+        {
+            break;
+        }
+        
+        remaining_size -= chunk_size;
+        stream.next_in = read_chunk.GetData();
+        stream.avail_in = chunk_size;
+        while((status == Z_OK) && (stream.avail_in > 0))
+        {
+            status = inflate(&stream, Z_NO_FLUSH);
+        }
+    }
+    
+    const bool is_done = (status == Z_STREAM_END) && (stream.total_out == entry_in.uncompressed_size);
+    inflateEnd(&stream);
+    
+    return is_done;
+}
+
+namespace CreatureModule {
+    CreatureLoadDataPacket::~CreatureLoadDataPacket()
+    {
+        if(src_chars)
+        {
+            delete [] src_chars;
+        }
+        
+        // region has to go before the file handle it was mapped from
+        delete mapped_region;
+        delete mapped_handle;
+    }
+    
+    // Load the json structure
+    bool LoadCreatureJSONData(const FName& filename_in,
+                              CreatureLoadDataPacket& load_data)
+    {
+        FString filename = filename_in.ToString();
+        TUniquePtr<IFileHandle> file_handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*filename));
+        if(!file_handle.IsValid())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureJSONData() - Could not open %s"), *filename);
+            return false;
+        }
+        
+        // The file is read straight into the buffer the json is parsed in place from
+        const int64 source_size = file_handle->Size();
+        char * source_chars = new char[source_size + 1];
+        if(!file_handle->Read((uint8 *)source_chars, source_size))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureJSONData() - Could not read %s"), *filename);
+            delete [] source_chars;
+            return false;
+        }
+        
+        source_chars[source_size] = 0;
+        return LoadCreatureJSONDataFromBuffer(source_chars, load_data);
+    }
+    
+    bool LoadCreatureJSONDataFromString(const FString& string_in,
+                                        CreatureLoadDataPacket& load_data)
+    {
+        // Converted once, straight into the buffer the json is parsed in place from
+        const int32 source_size = FTCHARToUTF8_Convert::ConvertedLength(*string_in, string_in.Len());
+        char * source_chars = new char[source_size + 1];
+        FTCHARToUTF8_Convert::Convert((ANSICHAR *)source_chars, source_size, *string_in, string_in.Len());
+        source_chars[source_size] = 0;
+        
+        return LoadCreatureJSONDataFromBuffer(source_chars, load_data);
+    }
+    
+    bool LoadCreatureJSONDataFromCompressedBuffer(const TArray<uint8>& data_in,
+                                                  CreatureLoadDataPacket& load_data)
+    {
+        FArchiveLoadCompressedProxy decompressor(data_in, NAME_Zlib, ECompressionFlags::COMPRESS_ZLIB);
+        if(decompressor.IsError() || (data_in.Num() == 0))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureJSONDataFromCompressedBuffer() - Could not uncompress data"));
+            return false;
+        }
+        
+        // The buffer was saved as a serialized byte array, its size leads the inflated stream
+        int32 source_size = 0;
+        decompressor << source_size;
+        if(decompressor.IsError() || (source_size <= 0))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureJSONDataFromCompressedBuffer() - Could not uncompress data"));
+            return false;
+        }
+        
+        // Inflated straight into the buffer the json is parsed in place from
+        char * source_chars = new char[source_size + 1];
+        decompressor.Serialize(source_chars, source_size);
+        if(decompressor.IsError())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureJSONDataFromCompressedBuffer() - Could not uncompress data"));
+            delete [] source_chars;
+            return false;
+        }
+        
+        source_chars[source_size] = 0;
+        return LoadCreatureJSONDataFromBuffer(source_chars, load_data);
+    }
+    
+    bool LoadCreatureJSONDataFromBuffer(char * chars_in,
+                                        CreatureLoadDataPacket& load_data)
+    {
+        char *endptr;
+        JsonParseStatus status = jsonParse(chars_in, &endptr, &load_data.base_node, load_data.allocator);
+        
+        load_data.src_chars = chars_in;
+        
+        if(status != JSON_PARSE_OK) {
+            std::cerr<<"LoadCreatureJSONData() - Error parsing JSON!"<<std::endl;
+            return false;
+        }
+        
+        // Index the clips once, every animation looks its clip up by name
+        JsonNode * json_root = load_data.base_node.toNode();
+        JsonNode * json_anim_base = json_root ? GetJSONLevelNodeFromKey(*json_root, "animation") : NULL;
+        if(json_anim_base)
+        {
+            for(JsonIterator it = JsonBegin(json_anim_base->value);
+                it != JsonEnd(json_anim_base->value); ++it)
+            {
+                load_data.json_clips.Add(FName((*it)->key), *it);
+            }
+        }
+        
+        return true;
+    }
+    
+    bool LoadCreatureZipJSONData(const FName& filename_in,
+                                 CreatureLoadDataPacket& load_data)
+    {
+        FString filename = filename_in.ToString();
+        TUniquePtr<IFileHandle> file_handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*filename));
+        if(!file_handle.IsValid())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureZipJSONData() - Could not open %s"), *filename);
+            return false;
+        }
+        
+        // The json is the first entry of the archive
+        ZipEntryInfo entry_info;
+        if(!FindFirstZipEntry(*file_handle, entry_info))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureZipJSONData() - %s is not a readable zip archive"), *filename);
+            return false;
+        }
+        
+        // The entry goes straight into the buffer the json is parsed in place from
+        char * source_chars = new char[entry_info.uncompressed_size + 1];
+        bool is_read = false;
+        if(entry_info.method == 0)
+        {
+            // stored without compression
+            is_read = (entry_info.compressed_size == entry_info.uncompressed_size)
+                && file_handle->Seek(entry_info.data_offset)
+                && file_handle->Read((uint8 *)source_chars, entry_info.uncompressed_size);
+        }
+        else if(entry_info.method == Z_DEFLATED)
+        {
+            is_read = InflateZipEntry(*file_handle, entry_info, (uint8 *)source_chars);
+        }
+        
+        if(!is_read)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadCreatureZipJSONData() - Could not extract the json from %s"), *filename);
+            delete [] source_chars;
+            return false;
+        }
+        
+        source_chars[entry_info.uncompressed_size] = 0;
+        return LoadCreatureJSONDataFromBuffer(source_chars, load_data);
+    }
+
+    bool IsCreatureBinaryData(const uint8 * data_in, int64 size_in)
+    {
+        return ValidateBinaryData(data_in, size_in);
+    }
+    
+    bool LoadCreatureBinaryData(const FName& filename_in,
+                                CreatureLoadDataPacket& load_data)
+    {
+        FString filename = filename_in.ToString();
+        IPlatformFile& platform_file = FPlatformFileManager::Get().GetPlatformFile();
+        
+        IMappedFileHandle * mapped_handle = platform_file.OpenMapped(*filename);
+        if(mapped_handle)
+        {
+            IMappedFileRegion * mapped_region = mapped_handle->MapRegion(0, mapped_handle->GetFileSize());
+            if(mapped_region)
+            {
+                load_data.mapped_handle = mapped_handle;
+                load_data.mapped_region = mapped_region;
+                load_data.binary_data = mapped_region->GetMappedPtr();
+                load_data.binary_size = mapped_region->GetMappedSize();
+            }
+            else {
+                delete mapped_handle;
+            }
+        }
+        
+        if(load_data.binary_data == NULL)
+        {
+            // Platform cannot memory map this file, just read it in
+            if(FFileHelper::LoadFileToArray(load_data.binary_storage, *filename) == false)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("LoadCreatureBinaryData() - Could not read %s"), *filename);
+                return false;
+            }
+            
+            load_data.binary_data = load_data.binary_storage.GetData();
+            load_data.binary_size = load_data.binary_storage.Num();
+        }
+        
+        return PrepareBinaryPacket(load_data);
+    }
+    
+    bool LoadCreatureBinaryDataFromBuffer(const TArray<uint8>& data_in,
+                                          CreatureLoadDataPacket& load_data)
+    {
+        load_data.binary_data = data_in.GetData();
+        load_data.binary_size = data_in.Num();
+        
+        return PrepareBinaryPacket(load_data);
+    }
+    
+    bool CompileCreatureBinaryData(CreatureLoadDataPacket& load_data,
+                                   TArray<uint8>& data_out,
+                                   float bone_tolerance,
+                                   float displacement_tolerance)
+    {
+        data_out.Reset();
+        
+        if(load_data.isBinary())
+        {
+            // already compiled
+            data_out.Append(load_data.binary_data, load_data.binary_size);
+            return true;
+        }
+        
+        if(load_data.base_node.getTag() != JSON_TAG_OBJECT)
+        {
+            return false;
+        }
+        
+        Creature creature(load_data);
+        meshRenderBoneComposition * render_composition = creature.GetRenderComposition();
+        
+        CreatureBinaryWriter writer(data_out);
+        FileHeader header;
+        FMemory::Memzero(header);
+        header.magic = Magic;
+        header.version = Version;
+        header.header_size = sizeof(FileHeader);
+        writer.Reserve(sizeof(FileHeader));
+        
+        // mesh
+        header.num_pts = creature.GetTotalNumPoints();
+        header.num_indices = creature.GetTotalNumIndices();
+        header.points_offset = writer.Write(creature.GetGlobalPts(), header.num_pts * 3);
+        header.indices_offset = writer.Write(creature.GetGlobalIndices(), header.num_indices);
+        header.uvs_offset = writer.Write(creature.GetGlobalUvs(), header.num_pts * 2);
+        
+        // bones, in pre-order so parents are always created before their children
+        TArray<meshBone *> all_bones = render_composition->getRootBone()->getAllChildren();
+        TMap<meshBone *, int32> bone_slots;
+        TArray<BoneEntry> bone_entries;
+        bone_entries.SetNumZeroed(all_bones.Num());
+        for(int32 i = 0; i < all_bones.Num(); i++)
+        {
+            meshBone * cur_bone = all_bones[i];
+            bone_slots.Add(cur_bone, i);
+            
+            BoneEntry& cur_entry = bone_entries[i];
+            cur_entry.name_idx = writer.AddName(cur_bone->getKey());
+            cur_entry.tag_id = cur_bone->getTagId();
+            cur_entry.parent_slot = cur_bone->getParent() ? bone_slots[cur_bone->getParent()] : -1;
+            FMemory::Memcpy(cur_entry.rest_parent_mat, glm::value_ptr(cur_bone->getRestParentMat()), sizeof(float) * 16);
+            cur_entry.local_rest_start_pt[0] = cur_bone->getLocalRestStartPt().x;
+            cur_entry.local_rest_start_pt[1] = cur_bone->getLocalRestStartPt().y;
+            cur_entry.local_rest_end_pt[0] = cur_bone->getLocalRestEndPt().x;
+            cur_entry.local_rest_end_pt[1] = cur_bone->getLocalRestEndPt().y;
+        }
+        
+        header.num_bones = bone_entries.Num();
+        header.bones_offset = writer.Write(bone_entries.GetData(), bone_entries.Num());
+        
+        // regions and their weights
+        TArray<meshRenderRegion *>& regions = render_composition->getRegions();
+        TArray<RegionEntry> region_entries;
+        region_entries.SetNumZeroed(regions.Num());
+        for(int32 i = 0; i < regions.Num(); i++)
+        {
+            meshRenderRegion * cur_region = regions[i];
+            RegionEntry& cur_entry = region_entries[i];
+            cur_entry.name_idx = writer.AddName(cur_region->getName());
+            cur_entry.tag_id = cur_region->getTagId();
+            cur_entry.start_pt_index = cur_region->getStartPtIndex();
+            cur_entry.end_pt_index = cur_region->getEndPtIndex();
+            cur_entry.start_index = cur_region->getStartIndex();
+            cur_entry.end_index = cur_region->getEndIndex();
+            
+            // The influence table is written as is, loading skips building it from dense weights
+            TArray<int32> influence_bones;
+            for(auto& cur_key : cur_region->getInfluenceBoneKeys())
+            {
+                influence_bones.Add(writer.AddName(cur_key));
+            }
+            
+            const TArray<meshBoneInfluence>& influences = cur_region->getInfluences();
+            TArray<InfluenceEntry> influence_entries;
+            influence_entries.SetNumZeroed(influences.Num());
+            for(int32 j = 0; j < influences.Num(); j++)
+            {
+                influence_entries[j].bone_index = influences[j].bone_index;
+                influence_entries[j].weight = influences[j].weight;
+            }
+            
+            const TArray<uint8>& influence_counts = cur_region->getInfluenceCounts();
+            cur_entry.num_influence_bones = influence_bones.Num();
+            cur_entry.influence_bones_offset = writer.Write(influence_bones.GetData(), influence_bones.Num());
+            cur_entry.influences_offset = writer.Write(influence_entries.GetData(), influence_entries.Num());
+            cur_entry.influence_counts_offset = writer.Write(influence_counts.GetData(), influence_counts.Num());
+        }
+        
+        header.num_regions = region_entries.Num();
+        header.regions_offset = writer.Write(region_entries.GetData(), region_entries.Num());
+        
+        // animation names
+        TArray<int32> animation_name_indices;
+        for(auto& cur_name : creature.GetAnimationNames())
+        {
+            animation_name_indices.Add(writer.AddName(cur_name));
+        }
+        
+        header.num_animation_names = animation_name_indices.Num();
+        header.animation_names_offset = writer.Write(animation_name_indices.GetData(), animation_name_indices.Num());
+        
+        // uv swap items
+        TArray<UVSwapEntry> uv_swap_entries;
+        for(auto& cur_swap : creature.GetUvSwapPackets())
+        {
+            for(auto& cur_packet : cur_swap.Value)
+            {
+                UVSwapEntry new_entry;
+                new_entry.region_name_idx = writer.AddName(cur_swap.Key);
+                new_entry.tag = cur_packet.tag;
+                new_entry.local_offset[0] = cur_packet.local_offset.x;
+                new_entry.local_offset[1] = cur_packet.local_offset.y;
+                new_entry.global_offset[0] = cur_packet.global_offset.x;
+                new_entry.global_offset[1] = cur_packet.global_offset.y;
+                new_entry.scale[0] = cur_packet.scale.x;
+                new_entry.scale[1] = cur_packet.scale.y;
+                uv_swap_entries.Add(new_entry);
+            }
+        }
+        
+        header.num_uv_swap_items = uv_swap_entries.Num();
+        header.uv_swap_items_offset = writer.Write(uv_swap_entries.GetData(), uv_swap_entries.Num());
+        
+        // anchor points
+        TArray<AnchorPointEntry> anchor_entries;
+        for(auto& cur_anchor : creature.GetAnchorPointMap())
+        {
+            AnchorPointEntry new_entry;
+            FMemory::Memzero(new_entry);
+            new_entry.clip_name_idx = writer.AddName(cur_anchor.Key);
+            new_entry.point[0] = cur_anchor.Value.x;
+            new_entry.point[1] = cur_anchor.Value.y;
+            anchor_entries.Add(new_entry);
+        }
+        
+        header.num_anchor_points = anchor_entries.Num();
+        header.anchor_points_offset = writer.Write(anchor_entries.GetData(), anchor_entries.Num());
+        
+        // animation clips, only the stored keys are written and interpolated again on load
+        TArray<ClipEntry> clip_entries;
+        for(auto& cur_name : creature.GetAnimationNames())
+        {
+            CreatureAnimation cur_animation(load_data, cur_name);
+            
+            ClipEntry new_clip;
+            FMemory::Memzero(new_clip);
+            new_clip.name_idx = writer.AddName(cur_name);
+            new_clip.start_time = (int32)cur_animation.getStartTime();
+            new_clip.end_time = (int32)cur_animation.getEndTime();
+            new_clip.flags = cur_animation.getOpacityCache().allReady() ? ClipHasOpacity : 0;
+            int32 num_frames = GetNumFrames(new_clip);
+            
+            meshBoneCacheManager& bones_cache = cur_animation.getBonesCache();
+            const TArray<FName>& flat_bone_keys = bones_cache.getFlatBoneKeys();
+            const TArray<float>& flat_bone_values = bones_cache.getFlatCache();
+            if((bone_tolerance > 0) && bones_cache.compressTracks(bone_tolerance))
+            {
+                // bones are stored as tracks of the keys kept by the compression
+                const TArray<meshBoneCompressedTrack>& bone_tracks = bones_cache.getCompressedTracks();
+                TArray<BoneTrackEntry> track_entries;
+                track_entries.SetNumZeroed(bone_tracks.Num());
+                for(int32 i = 0; i < bone_tracks.Num(); i++)
+                {
+                    BoneTrackEntry& cur_entry = track_entries[i];
+                    cur_entry.name_idx = writer.AddName(flat_bone_keys[i]);
+                    cur_entry.first_key = bone_tracks[i].first_key;
+                    cur_entry.num_keys = bone_tracks[i].num_keys;
+                    FMemory::Memcpy(cur_entry.bounds_min, bone_tracks[i].bounds_min, sizeof(cur_entry.bounds_min));
+                    FMemory::Memcpy(cur_entry.bounds_step, bone_tracks[i].bounds_step, sizeof(cur_entry.bounds_step));
+                }
+                
+                new_clip.flags |= ClipHasCompressedBones;
+                new_clip.num_bone_tracks = track_entries.Num();
+                new_clip.bone_tracks_offset = writer.Write(track_entries.GetData(), track_entries.Num());
+                new_clip.bone_track_frames_offset = writer.Write(bones_cache.getCompressedFrames().GetData(),
+                                                                 bones_cache.getCompressedFrames().Num());
+                new_clip.bone_track_values_offset = writer.Write(bones_cache.getCompressedValues().GetData(),
+                                                                 bones_cache.getCompressedValues().Num());
+            }
+            else if(flat_bone_values.Num() > 0)
+            {
+                // bones come from the flattened cache, one row of bones per stored key
+                const TArray<int32>& bone_key_frames = bones_cache.getKeyFrames();
+                TArray<FrameEntry> bone_frames;
+                TArray<BoneKey> bone_keys;
+                bone_frames.SetNumZeroed(num_frames);
+                bone_keys.SetNumZeroed(flat_bone_values.Num() / 4);
+                for(int32 i = 0; i < bone_key_frames.Num(); i++)
+                {
+                    bone_frames[bone_key_frames[i]].first_key = (uint32)(i * flat_bone_keys.Num());
+                    bone_frames[bone_key_frames[i]].num_keys = (uint32)flat_bone_keys.Num();
+                }
+                
+                for(int32 i = 0; i < bone_keys.Num(); i++)
+                {
+                    const float * read_vals = flat_bone_values.GetData() + (i * 4);
+                    bone_keys[i].name_idx = writer.AddName(flat_bone_keys[i % flat_bone_keys.Num()]);
+                    bone_keys[i].start_pt[0] = read_vals[0];
+                    bone_keys[i].start_pt[1] = read_vals[1];
+                    bone_keys[i].end_pt[0] = read_vals[2];
+                    bone_keys[i].end_pt[1] = read_vals[3];
+                }
+                
+                new_clip.bone_keys_offset = writer.Write(bone_keys.GetData(), bone_keys.Num());
+                new_clip.bone_frames_offset = writer.Write(bone_frames.GetData(), bone_frames.Num());
+            }
+            else {
+                new_clip.bone_frames_offset = WriteBinaryTrack<meshBoneCache, BoneKey>(
+                    writer,
+                    bones_cache.getCacheTable(),
+                    bones_cache.getKeyFrames(),
+                    num_frames,
+                    [](const meshBoneCache& cache_in, BoneKey& key_out)
+                    {
+                        key_out.start_pt[0] = cache_in.getWorldStartPt().x;
+                        key_out.start_pt[1] = cache_in.getWorldStartPt().y;
+                        key_out.end_pt[0] = cache_in.getWorldEndPt().x;
+                        key_out.end_pt[1] = cache_in.getWorldEndPt().y;
+                    },
+                    new_clip.bone_keys_offset);
+            }
+            
+            auto& displacement_cache = cur_animation.getDisplacementCache();
+            if((displacement_tolerance > 0) && displacement_cache.compressTracks(displacement_tolerance))
+            {
+                // displacements are stored as basis shapes plus per key coefficients
+                const TArray<meshDisplacementBasisTrack>& basis_tracks = displacement_cache.getBasisTracks();
+                TArray<DisplacementTrackEntry> track_entries;
+                track_entries.SetNumZeroed(basis_tracks.Num());
+                for(int32 i = 0; i < basis_tracks.Num(); i++)
+                {
+                    DisplacementTrackEntry& cur_entry = track_entries[i];
+                    cur_entry.name_idx = writer.AddName(basis_tracks[i].key);
+                    cur_entry.num_local_pts = basis_tracks[i].num_local_pts;
+                    cur_entry.num_post_pts = basis_tracks[i].num_post_pts;
+                    cur_entry.num_basis = basis_tracks[i].num_basis;
+                    cur_entry.basis_offset = basis_tracks[i].basis_offset;
+                    cur_entry.coeffs_offset = basis_tracks[i].coeffs_offset;
+                }
+                
+                const TArray<int32>& displacement_key_frames = displacement_cache.getKeyFrames();
+                new_clip.flags |= ClipHasDisplacementBasis;
+                new_clip.num_displacement_tracks = track_entries.Num();
+                new_clip.num_displacement_key_frames = displacement_key_frames.Num();
+                new_clip.displacement_tracks_offset = writer.Write(track_entries.GetData(), track_entries.Num());
+                new_clip.displacement_key_frames_offset = writer.Write(displacement_key_frames.GetData(), displacement_key_frames.Num());
+                new_clip.displacement_basis_offset = writer.Write(displacement_cache.getBasisValues().GetData(),
+                                                                  displacement_cache.getBasisValues().Num());
+                new_clip.displacement_coeffs_offset = writer.Write(displacement_cache.getBasisCoeffs().GetData(),
+                                                                   displacement_cache.getBasisCoeffs().Num());
+            }
+            
+            // displacement points go into one block, keys point into it
+            auto& displacement_table = displacement_cache.getCacheTable();
+            TArray<glm::vec2> displacement_pts;
+            for(auto& cur_frame : displacement_table)
+            {
+                for(auto& cur_cache : cur_frame)
+                {
+                    displacement_pts.Append(cur_cache.getLocalDisplacements());
+                    displacement_pts.Append(cur_cache.getPostDisplacements());
+                }
+            }
+            
+            uint32 displacement_pts_offset = writer.Write(displacement_pts.GetData(), displacement_pts.Num());
+            uint32 displacement_pts_idx = 0;
+            new_clip.displacement_frames_offset = WriteBinaryTrack<meshDisplacementCache, DisplacementKey>(
+                writer,
+                displacement_table,
+                displacement_cache.getKeyFrames(),
+                num_frames,
+                [&](const meshDisplacementCache& cache_in, DisplacementKey& key_out)
+                {
+                    key_out.num_local_pts = cache_in.getLocalDisplacements().Num();
+                    key_out.num_post_pts = cache_in.getPostDisplacements().Num();
+                    key_out.pts_offset = displacement_pts_offset + (displacement_pts_idx * sizeof(glm::vec2));
+                    displacement_pts_idx += key_out.num_local_pts + key_out.num_post_pts;
+                },
+                new_clip.displacement_keys_offset);
+            
+            new_clip.uv_frames_offset = WriteBinaryTrack<meshUVWarpCache, UVWarpKey>(
+                writer,
+                cur_animation.getUVWarpCache().getCacheTable(),
+                cur_animation.getUVWarpCache().getKeyFrames(),
+                num_frames,
+                [](const meshUVWarpCache& cache_in, UVWarpKey& key_out)
+                {
+                    key_out.enabled = cache_in.getEnabled() ? 1 : 0;
+                    key_out.level = cache_in.getLevel();
+                    key_out.local_offset[0] = cache_in.getUvWarpLocalOffset().x;
+                    key_out.local_offset[1] = cache_in.getUvWarpLocalOffset().y;
+                    key_out.global_offset[0] = cache_in.getUvWarpGlobalOffset().x;
+                    key_out.global_offset[1] = cache_in.getUvWarpGlobalOffset().y;
+                    key_out.scale[0] = cache_in.getUvWarpScale().x;
+                    key_out.scale[1] = cache_in.getUvWarpScale().y;
+                },
+                new_clip.uv_keys_offset);
+            
+            new_clip.opacity_frames_offset = WriteBinaryTrack<meshOpacityCache, OpacityKey>(
+                writer,
+                cur_animation.getOpacityCache().getCacheTable(),
+                cur_animation.getOpacityCache().getKeyFrames(),
+                num_frames,
+                [](const meshOpacityCache& cache_in, OpacityKey& key_out)
+                {
+                    key_out.opacity = cache_in.getOpacity();
+                    key_out.red = cache_in.getRed();
+                    key_out.green = cache_in.getGreen();
+                    key_out.blue = cache_in.getBlue();
+                },
+                new_clip.opacity_keys_offset);
+            
+            clip_entries.Add(new_clip);
+        }
+        
+        header.num_clips = clip_entries.Num();
+        header.clips_offset = writer.Write(clip_entries.GetData(), clip_entries.Num());
+        
+        // names last, once everything has registered theirs
+        header.names_offset = writer.WriteNames();
+        header.num_names = writer.GetNumNames();
+        
+        writer.Align();
+        header.total_size = (uint32)data_out.Num();
+        writer.Overwrite(0, header);
+        
+        return true;
+    }
+
+    // Creature class
+    Creature::Creature(CreatureLoadDataPacket& load_data)
+    {
+		anchor_points_active = false;
+        LoadFromData(load_data);
+        shared_mesh = MakeShareable(new CreatureMeshData(global_indices, global_pts));
+    }
+    
+    Creature::Creature(const Creature& prototype_in)
+    {
+        shared_mesh = prototype_in.shared_mesh;
+        global_indices = shared_mesh->global_indices;
+        global_pts = shared_mesh->global_pts;
+        total_num_pts = prototype_in.total_num_pts;
+        total_num_indices = prototype_in.total_num_indices;
+        
+        // uvs get warped and render buffers get posed per instance
+        global_uvs = new glm::float32[total_num_pts * 2];
+        FMemory::Memcpy(global_uvs, prototype_in.global_uvs, sizeof(glm::float32) * total_num_pts * 2);
+        render_pts = new glm::float32[total_num_pts * 3];
+        FMemory::Memcpy(render_pts, prototype_in.render_pts, sizeof(glm::float32) * total_num_pts * 3);
+        render_colours = new glm::uint8[total_num_pts * 4];
+        FMemory::Memcpy(render_colours, prototype_in.render_colours, sizeof(glm::uint8) * total_num_pts * 4);
+        
+        // skeleton
+        meshBone * root_bone = prototype_in.render_composition->getRootBone()->cloneHierarchy();
+        render_composition = new meshRenderBoneComposition();
+        render_composition->setRootBone(root_bone);
+        render_composition->initBoneMap();
+        render_composition->setBoneSlotLayout(prototype_in.render_composition->getBoneSlotLayout());
+        
+        // regions
+        for(auto cur_region : prototype_in.render_composition->getRegions())
+        {
+            render_composition->addRegion(cur_region->clone(global_indices,
+                                                            global_pts,
+                                                            global_uvs,
+                                                            root_bone,
+                                                            render_composition->getBonesMap()));
+        }
+        
+        render_composition->initRegionsMap();
+        
+        animation_names = prototype_in.animation_names;
+        uv_swap_packets = prototype_in.uv_swap_packets;
+        active_uv_swap_actions = prototype_in.active_uv_swap_actions;
+        anchor_point_map = prototype_in.anchor_point_map;
+        anchor_points_active = prototype_in.anchor_points_active;
+    }
+    
+    Creature::~Creature()
+    {
+        // global_pts and global_indices are owned by shared_mesh
+        delete [] global_uvs;
+        delete [] render_colours;
+        delete render_composition;
+        delete [] render_pts;
+
+		global_pts = nullptr;
+		global_indices = nullptr;
+		global_uvs = nullptr;
+		render_composition = nullptr;
+		render_pts = nullptr;
+    }
+    
+    glm::uint32 *
+    Creature::GetGlobalIndices()
+    {
+        return global_indices;
+    }
+    
+    glm::float32 *
+    Creature::GetGlobalPts()
+    {
+        return global_pts;
+    }
+    
+    glm::float32 *
+    Creature::GetGlobalUvs()
+    {
+        return global_uvs;
+    }
+    
+    glm::float32 *
+    Creature::GetRenderPts()
+    {
+        return render_pts;
+    }
+    
+    glm::uint8 *
+    Creature::GetRenderColours()
+    {
+        return render_colours;
+    }
+    
+    int32
+    Creature::GetTotalNumPoints() const
+    {
+        return total_num_pts;
+    }
+    
+    int32
+    Creature::GetTotalNumIndices() const
+    {
+        return total_num_indices;
+    }
+    
+    meshRenderBoneComposition *
+    Creature::GetRenderComposition()
+    {
+        return render_composition;
+    }
+    
+    void
+    Creature::FillRenderColours(glm::uint8 r, glm::uint8 g, glm::uint8 b, glm::uint8 a)
+    {
+        for(auto i = 0; i < total_num_pts; i++)
+        {
+            glm::uint8 * cur_colour = render_colours + (i * 4);
+            cur_colour[0] = r;
+            cur_colour[1] = g;
+            cur_colour[2] = b;
+            cur_colour[3] = a;
+        }
+    }
+
+    const TArray<FName>& 
+    Creature::GetAnimationNames() const
+    {
+        return animation_names;
+    }
+
+	const TMap<FName, TArray<CreatureUVSwapPacket> >& 
+	Creature::GetUvSwapPackets() const
+	{
+		return uv_swap_packets;
+	}
+
+	void 
+	Creature::SetActiveItemSwap(const FName& region_name, int32 swap_idx)
+	{
+		active_uv_swap_actions.Add(region_name, swap_idx);
+	}
+
+	void 
+	Creature::RemoveActiveItemSwap(const FName& region_name)
 	{
 		active_uv_swap_actions.Remove(region_name);
 	}
@@ -945,76 +1987,477 @@ namespace CreatureModule {
 		return glm::vec2(0, 0);
 	}
 
+	const TMap<FName, glm::vec2>&
+	Creature::GetAnchorPointMap() const
+	{
+		return anchor_point_map;
+	}
+
     void
     Creature::LoadFromData(CreatureLoadDataPacket& load_data)
     {
-        JsonNode * json_root = load_data.base_node.toNode();
-        
-        // Load points and topology
-        JsonNode * json_mesh = GetJSONLevelNodeFromKey(*json_root, "mesh");
-        global_pts = ReadJSONPoints3D(*json_mesh, "points", total_num_pts);
-        global_indices = ReadJSONUints(*json_mesh,"indices", total_num_indices);
-        global_uvs = ReadJSONPoints2D(*json_mesh, "uvs", total_num_pts);
+        if(load_data.isBinary())
+        {
+            LoadFromBinaryData(load_data);
+            return;
+        }
+        
+        JsonNode * json_root = load_data.base_node.toNode();
+        
+        // Load points and topology
+        JsonNode * json_mesh = GetJSONLevelNodeFromKey(*json_root, "mesh");
+        global_pts = ReadJSONPoints3D(*json_mesh, "points", total_num_pts);
+        global_indices = ReadJSONUints(*json_mesh,"indices", total_num_indices);
+        global_uvs = ReadJSONPoints2D(*json_mesh, "uvs", total_num_pts);
+        
+        render_colours = new glm::uint8[total_num_pts * 4];
+        render_pts = new glm::float32[total_num_pts * 3];
+        FillRenderColours(255, 255, 255, 255);
+        
+        // Load bones
+        meshBone * root_bone = CreateBones(*json_root, "skeleton");
+        
+        // Load regions
+        TArray<meshRenderRegion *> regions = CreateRegions(*json_mesh,
+                                                                "regions",
+                                                                global_indices,
+                                                                global_pts,
+                                                                global_uvs);
+        
+        // Add into composition
+        InitRenderComposition(root_bone, regions);
+
+        // Fill up available animation names
+        JsonNode * json_anim_base = GetJSONLevelNodeFromKey(*json_root, "animation");
+        animation_names = GetJSONKeysFromNode(*json_anim_base);
+
+		// Fill up uv swap packets
+		
+		JsonNode * json_uv_swap_base = GetJSONLevelNodeFromKey(*json_root, "uv_swap_items");
+		if (json_uv_swap_base)
+		{
+			uv_swap_packets = FillSwapUVPacketMap(*json_uv_swap_base);
+		}
+
+		// Load Anchor Points
+		JsonNode * anchor_point_base = GetJSONLevelNodeFromKey(*json_root, "anchor_points_items");
+		if (anchor_point_base)
+		{
+			anchor_point_map = FillAnchorPointMap(*anchor_point_base);
+		}
+    }
+
+    void
+    Creature::LoadFromBinaryData(CreatureLoadDataPacket& load_data)
+    {
+        const FileHeader& header = GetBinaryHeader(load_data);
+        const TArray<FName>& names = load_data.binary_names;
+        
+        // Load points and topology
+        total_num_pts = header.num_pts;
+        total_num_indices = header.num_indices;
+        
+        global_pts = new glm::float32[total_num_pts * 3];
+        FMemory::Memcpy(global_pts, GetBinaryBlock<float>(load_data, header.points_offset), sizeof(glm::float32) * total_num_pts * 3);
+        
+        global_indices = new glm::uint32[total_num_indices];
+        FMemory::Memcpy(global_indices, GetBinaryBlock<uint32>(load_data, header.indices_offset), sizeof(glm::uint32) * total_num_indices);
+        
+        global_uvs = new glm::float32[total_num_pts * 2];
+        FMemory::Memcpy(global_uvs, GetBinaryBlock<float>(load_data, header.uvs_offset), sizeof(glm::float32) * total_num_pts * 2);
+        
+        render_colours = new glm::uint8[total_num_pts * 4];
+        render_pts = new glm::float32[total_num_pts * 3];
+        FillRenderColours(255, 255, 255, 255);
+        
+        // Load bones, parents are always stored before their children
+        const BoneEntry * bone_entries = GetBinaryBlock<BoneEntry>(load_data, header.bones_offset);
+        TArray<meshBone *> bone_slots;
+        bone_slots.SetNumZeroed(header.num_bones);
+        for(int32 i = 0; i < header.num_bones; i++)
+        {
+            const BoneEntry& cur_entry = bone_entries[i];
+            meshBone * new_bone = new meshBone(names[cur_entry.name_idx],
+                                               glm::vec4(0),
+                                               glm::vec4(0),
+                                               glm::make_mat4(cur_entry.rest_parent_mat));
+            new_bone->getLocalRestStartPt() = glm::vec4(cur_entry.local_rest_start_pt[0], cur_entry.local_rest_start_pt[1], 0, 1.0f);
+            new_bone->getLocalRestEndPt() = glm::vec4(cur_entry.local_rest_end_pt[0], cur_entry.local_rest_end_pt[1], 0, 1.0f);
+            new_bone->calcRestData();
+            new_bone->setTagId(cur_entry.tag_id);
+            
+            if(cur_entry.parent_slot >= 0) {
+                bone_slots[cur_entry.parent_slot]->addChild(new_bone);
+            }
+            
+            bone_slots[i] = new_bone;
+        }
+        
+        // Load regions
+        const RegionEntry * region_entries = GetBinaryBlock<RegionEntry>(load_data, header.regions_offset);
+        TArray<meshRenderRegion *> regions;
+        for(int32 i = 0; i < header.num_regions; i++)
+        {
+            const RegionEntry& cur_entry = region_entries[i];
+            meshRenderRegion * new_region = new meshRenderRegion(global_indices,
+                                                                 global_pts,
+                                                                 global_uvs,
+                                                                 cur_entry.start_pt_index,
+                                                                 cur_entry.end_pt_index,
+                                                                 cur_entry.start_index,
+                                                                 cur_entry.end_index);
+            
+            new_region->setName(names[cur_entry.name_idx]);
+            new_region->setTagId(cur_entry.tag_id);
+            
+            int32 region_num_pts = new_region->getNumPts();
+            const int32 * influence_bones = GetBinaryBlock<int32>(load_data, cur_entry.influence_bones_offset);
+            TArray<FName> bone_keys;
+            bone_keys.Reserve(cur_entry.num_influence_bones);
+            for(int32 j = 0; j < cur_entry.num_influence_bones; j++)
+            {
+                bone_keys.Add(names[influence_bones[j]]);
+            }
+            
+            const InfluenceEntry * influence_entries = GetBinaryBlock<InfluenceEntry>(load_data, cur_entry.influences_offset);
+            TArray<meshBoneInfluence> influences;
+            influences.SetNumUninitialized(region_num_pts * MaxInfluences);
+            for(int32 j = 0; j < influences.Num(); j++)
+            {
+                influences[j].bone_index = influence_entries[j].bone_index;
+                influences[j].weight = influence_entries[j].weight;
+            }
+            
+            const uint8 * influence_counts = GetBinaryBlock<uint8>(load_data, cur_entry.influence_counts_offset);
+            new_region->setInfluences(bone_keys, MoveTemp(influences), TArray<uint8>(influence_counts, region_num_pts));
+            
+            regions.Add(new_region);
+        }
+        
+        // Add into composition
+        InitRenderComposition(bone_slots[0], regions);
+        
+        // Fill up available animation names
+        const int32 * animation_name_indices = GetBinaryBlock<int32>(load_data, header.animation_names_offset);
+        animation_names.Reset(header.num_animation_names);
+        for(int32 i = 0; i < header.num_animation_names; i++)
+        {
+            animation_names.Add(names[animation_name_indices[i]]);
+        }
+        
+        // Fill up uv swap packets
+        const UVSwapEntry * uv_swap_entries = GetBinaryBlock<UVSwapEntry>(load_data, header.uv_swap_items_offset);
+        for(int32 i = 0; i < header.num_uv_swap_items; i++)
+        {
+            const UVSwapEntry& cur_entry = uv_swap_entries[i];
+            uv_swap_packets.FindOrAdd(names[cur_entry.region_name_idx]).Add(
+                CreatureUVSwapPacket(glm::make_vec2(cur_entry.local_offset),
+                                     glm::make_vec2(cur_entry.global_offset),
+                                     glm::make_vec2(cur_entry.scale),
+                                     cur_entry.tag));
+        }
+        
+        // Load Anchor Points
+        const AnchorPointEntry * anchor_entries = GetBinaryBlock<AnchorPointEntry>(load_data, header.anchor_points_offset);
+        for(int32 i = 0; i < header.num_anchor_points; i++)
+        {
+            anchor_point_map.Add(names[anchor_entries[i].clip_name_idx], glm::make_vec2(anchor_entries[i].point));
+        }
+    }
+
+    void
+    Creature::InitRenderComposition(meshBone * root_bone, TArray<meshRenderRegion *>& regions)
+    {
+        render_composition = new meshRenderBoneComposition();
+        render_composition->setRootBone(root_bone);
+        render_composition->getRootBone()->computeRestParentTransforms();
+        
+        for(auto& cur_region : regions) {
+            cur_region->setMainBoneKey(root_bone->getKey());
+            cur_region->determineMainBone(root_bone);
+            render_composition->addRegion(cur_region);
+        }
+        
+        render_composition->initBoneMap();
+        render_composition->initRegionsMap();
+        
+        for(auto& cur_region : regions) {
+            cur_region->initFastNormalWeightMap(render_composition->getBonesMap());
+        }
+        
+        render_composition->resetToWorldRestPts();
+    }
+
+    
+    // CreatureCompressedPointCache class
+    CreatureCompressedPointCache::CreatureCompressedPointCache()
+    : num_floats(0)
+    {
+        for(int32 i = 0; i < 3; i++) {
+            bounds_min[i] = 0;
+            bounds_step[i] = 0;
+        }
+    }
+    
+    void
+    CreatureCompressedPointCache::compress(const TArray<glm::float32 *>& frames_in,
+                                           int32 num_floats_in,
+                                           int32 keyframe_interval)
+    {
+        clear();
+        if((frames_in.Num() == 0) || (num_floats_in <= 0)) {
+            return;
+        }
+        
+        num_floats = num_floats_in;
+        keyframe_interval = FMath::Max(keyframe_interval, 1);
+        
+        // Bounds of the whole clip per axis
+        float bounds_max[3];
+        for(int32 i = 0; i < 3; i++) {
+            bounds_min[i] = MAX_flt;
+            bounds_max[i] = -MAX_flt;
+        }
+        
+        for(auto cur_frame : frames_in) {
+            for(int32 k = 0; k < num_floats; k++) {
+                const int32 axis = k % 3;
+                bounds_min[axis] = FMath::Min(bounds_min[axis], cur_frame[k]);
+                bounds_max[axis] = FMath::Max(bounds_max[axis], cur_frame[k]);
+            }
+        }
+        
+        for(int32 i = 0; i < 3; i++) {
+            const float cur_range = bounds_max[i] - bounds_min[i];
+            bounds_step[i] = (cur_range > 0) ? (cur_range / (float)MAX_uint16) : 0.0f;
+        }
+        
+        TArray<uint16> cur_quantized;
+        cur_quantized.SetNumUninitialized(num_floats);
+        int32 cur_key_offset = -1;
+        int32 frames_since_key = 0;
+        
+        frame_key_offsets.Reserve(frames_in.Num());
+        frame_delta_offsets.Reserve(frames_in.Num());
+        
+        for(auto cur_frame : frames_in) {
+            for(int32 k = 0; k < num_floats; k++) {
+                const int32 axis = k % 3;
+                int32 cur_val = 0;
+                if(bounds_step[axis] > 0) {
+                    cur_val = FMath::RoundToInt((cur_frame[k] - bounds_min[axis]) / bounds_step[axis]);
+                }
+                
+                cur_quantized[k] = (uint16)FMath::Clamp(cur_val, 0, (int32)MAX_uint16);
+            }
+            
+            bool use_delta = (cur_key_offset >= 0) && (frames_since_key < keyframe_interval);
+            if(use_delta) {
+                const uint16 * key_vals = key_data.GetData() + cur_key_offset;
+                for(int32 k = 0; k < num_floats; k++) {
+                    const int32 cur_delta = (int32)cur_quantized[k] - (int32)key_vals[k];
+                    if((cur_delta < MIN_int8) || (cur_delta > MAX_int8)) {
+                        use_delta = false;
+                        break;
+                    }
+                }
+            }
+            
+            if(use_delta) {
+                const uint16 * key_vals = key_data.GetData() + cur_key_offset;
+                const int32 delta_offset = delta_data.AddUninitialized(num_floats);
+                int8 * delta_vals = delta_data.GetData() + delta_offset;
+                for(int32 k = 0; k < num_floats; k++) {
+                    delta_vals[k] = (int8)((int32)cur_quantized[k] - (int32)key_vals[k]);
+                }
+                
+                frame_key_offsets.Add(cur_key_offset);
+                frame_delta_offsets.Add(delta_offset);
+                frames_since_key++;
+            }
+            else {
+                cur_key_offset = key_data.Num();
+                key_data.Append(cur_quantized);
+                frame_key_offsets.Add(cur_key_offset);
+                frame_delta_offsets.Add(-1);
+                frames_since_key = 1;
+            }
+        }
+        
+        key_data.Shrink();
+        delta_data.Shrink();
+    }
+    
+    void
+    CreatureCompressedPointCache::clear()
+    {
+        num_floats = 0;
+        frame_key_offsets.Empty();
+        frame_delta_offsets.Empty();
+        key_data.Empty();
+        delta_data.Empty();
+    }
+    
+    bool
+    CreatureCompressedPointCache::isEmpty() const
+    {
+        return frame_key_offsets.Num() == 0;
+    }
+    
+    int32
+    CreatureCompressedPointCache::getNumFrames() const
+    {
+        return frame_key_offsets.Num();
+    }
+    
+    SIZE_T
+    CreatureCompressedPointCache::getAllocatedSize() const
+    {
+        return frame_key_offsets.GetAllocatedSize()
+            + frame_delta_offsets.GetAllocatedSize()
+            + key_data.GetAllocatedSize()
+            + delta_data.GetAllocatedSize();
+    }
+    
+    void
+    CreatureCompressedPointCache::gatherFrame(int32 frame_idx, int32 start_idx, int32 count, float * out_vals) const
+    {
+        const uint16 * key_vals = key_data.GetData() + frame_key_offsets[frame_idx] + start_idx;
+        const int32 delta_offset = frame_delta_offsets[frame_idx];
+        if(delta_offset < 0) {
+            for(int32 i = 0; i < count; i++) {
+                out_vals[i] = (float)key_vals[i];
+            }
+        }
+        else {
+            const int8 * delta_vals = delta_data.GetData() + delta_offset + start_idx;
+            for(int32 i = 0; i < count; i++) {
+                out_vals[i] = (float)((int32)key_vals[i] + (int32)delta_vals[i]);
+            }
+        }
+    }
+    
+    void
+    CreatureCompressedPointCache::decode(int32 floor_idx,
+                                         int32 ceil_idx,
+                                         float ratio,
+                                         glm::float32 * target_pts,
+                                         int32 num_target_floats) const
+    {
+        if(isEmpty()
+           || (num_floats != num_target_floats)
+           || !frame_key_offsets.IsValidIndex(floor_idx)
+           || !frame_key_offsets.IsValidIndex(ceil_idx))
+        {
+            return;
+        }
         
-        render_colours = new glm::uint8[total_num_pts * 4];
-        render_pts = new glm::float32[total_num_pts * 3];
-        FillRenderColours(255, 255, 255, 255);
+        // 12 floats are 4 whole points, so the per axis bounds repeat every 3 registers
+        const int32 block_size = 12;
+        const int32 chunk_blocks = 64;
         
-        // Load bones
-        meshBone * root_bone = CreateBones(*json_root, "skeleton");
+        VectorRegister min_vecs[3], step_vecs[3];
+        for(int32 r = 0; r < 3; r++) {
+            float cur_mins[4], cur_steps[4];
+            for(int32 l = 0; l < 4; l++) {
+                const int32 axis = ((r * 4) + l) % 3;
+                cur_mins[l] = bounds_min[axis];
+                cur_steps[l] = bounds_step[axis];
+            }
+            
+            min_vecs[r] = VectorLoad(cur_mins);
+            step_vecs[r] = VectorLoad(cur_steps);
+        }
         
-        // Load regions
-        TArray<meshRenderRegion *> regions = CreateRegions(*json_mesh,
-                                                                "regions",
-                                                                global_indices,
-                                                                global_pts,
-                                                                global_uvs);
+        const VectorRegister ratio_vec = VectorSetFloat1(ratio);
+        const int32 num_blocks = num_floats / block_size;
+        const int32 num_chunks = FMath::DivideAndRoundUp(num_blocks, chunk_blocks);
         
-        // Add into composition
-        render_composition = new meshRenderBoneComposition();
-        render_composition->setRootBone(root_bone);
-        render_composition->getRootBone()->computeRestParentTransforms();
+#ifdef CREATURE_MULTICORE
+		ParallelFor(num_chunks, [&](int32 i) {
+#else
+		for (int32 i = 0; i < num_chunks; i++) {
+#endif
+            float floor_vals[block_size], ceil_vals[block_size];
+            const int32 end_block = FMath::Min((i + 1) * chunk_blocks, num_blocks);
+            for(int32 j = i * chunk_blocks; j < end_block; j++) {
+                const int32 start_idx = j * block_size;
+                gatherFrame(floor_idx, start_idx, block_size, floor_vals);
+                gatherFrame(ceil_idx, start_idx, block_size, ceil_vals);
+                
+                for(int32 r = 0; r < 3; r++) {
+                    // Lerp in quantized space, then dequantize once
+                    const VectorRegister floor_vec = VectorLoad(floor_vals + (r * 4));
+                    const VectorRegister ceil_vec = VectorLoad(ceil_vals + (r * 4));
+                    const VectorRegister quantized_vec = VectorMultiplyAdd(VectorSubtract(ceil_vec, floor_vec), ratio_vec, floor_vec);
+                    VectorStore(VectorMultiplyAdd(quantized_vec, step_vecs[r], min_vecs[r]), target_pts + start_idx + (r * 4));
+                }
+            }
+#ifdef CREATURE_MULTICORE
+		});
+#else
+		}
+#endif
         
-        for(auto& cur_region : regions) {
-            cur_region->setMainBoneKey(root_bone->getKey());
-            cur_region->determineMainBone(root_bone);
-            render_composition->addRegion(cur_region);
+        // Leftover points
+        const int32 tail_start = num_blocks * block_size;
+        const int32 tail_count = num_floats - tail_start;
+        if(tail_count > 0) {
+            float floor_vals[block_size], ceil_vals[block_size];
+            gatherFrame(floor_idx, tail_start, tail_count, floor_vals);
+            gatherFrame(ceil_idx, tail_start, tail_count, ceil_vals);
+            for(int32 k = 0; k < tail_count; k++) {
+                const int32 axis = (tail_start + k) % 3;
+                const float cur_val = floor_vals[k] + (ratio * (ceil_vals[k] - floor_vals[k]));
+                target_pts[tail_start + k] = bounds_min[axis] + (cur_val * bounds_step[axis]);
+            }
+        }
+    }
+    
+    void
+    CreatureCompressedPointCache::serialize(FArchive& ar)
+    {
+        ar << num_floats;
+        for(int32 i = 0; i < 3; i++) {
+            ar << bounds_min[i];
+            ar << bounds_step[i];
         }
         
-        render_composition->initBoneMap();
-        render_composition->initRegionsMap();
+        ar << frame_key_offsets;
+        ar << frame_delta_offsets;
+        ar << key_data;
+        ar << delta_data;
+    }
+    
+    bool
+    CreatureCompressedPointCache::isValid(int32 num_floats_in) const
+    {
+        if((num_floats <= 0)
+           || (num_floats != num_floats_in)
+           || (frame_delta_offsets.Num() != frame_key_offsets.Num()))
+        {
+            return false;
+        }
         
-        for(auto& cur_region : regions) {
-            cur_region->initFastNormalWeightMap(render_composition->getBonesMap());
+        for(int32 i = 0; i < frame_key_offsets.Num(); i++) {
+            const int32 key_offset = frame_key_offsets[i];
+            const int32 delta_offset = frame_delta_offsets[i];
+            if((key_offset < 0) || ((int64)key_offset + num_floats > (int64)key_data.Num())) {
+                return false;
+            }
+            
+            if((delta_offset < -1) || ((delta_offset >= 0) && ((int64)delta_offset + num_floats > (int64)delta_data.Num()))) {
+                return false;
+            }
         }
         
-        render_composition->resetToWorldRestPts();
-
-        // Fill up available animation names
-        JsonNode * json_anim_base = GetJSONLevelNodeFromKey(*json_root, "animation");
-        animation_names = GetJSONKeysFromNode(*json_anim_base);
-
-		// Fill up uv swap packets
-		
-		JsonNode * json_uv_swap_base = GetJSONLevelNodeFromKey(*json_root, "uv_swap_items");
-		if (json_uv_swap_base)
-		{
-			uv_swap_packets = FillSwapUVPacketMap(*json_uv_swap_base);
-		}
-
-		// Load Anchor Points
-		JsonNode * anchor_point_base = GetJSONLevelNodeFromKey(*json_root, "anchor_points_items");
-		if (anchor_point_base)
-		{
-			anchor_point_map = FillAnchorPointMap(*anchor_point_base);
-		}
+        return true;
     }
-
     
     // CreatureAnimation class
     CreatureAnimation::CreatureAnimation(CreatureLoadDataPacket& load_data,
                                          const FName& name_in)
-    : name(name_in)
+    : name(name_in), bound_cache_pts(nullptr), bound_cache_num_frames(0), bound_cache_stride(0)
     {
             LoadFromData(name_in, load_data);
     }
@@ -1084,9 +2527,19 @@ namespace CreatureModule {
     CreatureAnimation::LoadFromData(const FName& name_in,
                                     CreatureLoadDataPacket& load_data)
     {
-        JsonNode * json_root = load_data.base_node.toNode();
-        JsonNode * json_anim_base = GetJSONLevelNodeFromKey(*json_root, "animation");
-        JsonNode * json_clip = GetJSONNodeFromKey(*json_anim_base, name_in);
+        if(load_data.isBinary())
+        {
+            LoadFromBinaryData(name_in, load_data);
+            return;
+        }
+        
+        JsonNode * json_clip = load_data.json_clips.FindRef(name_in);
+        if(json_clip == NULL)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CreatureAnimation::LoadFromData() - No animation clip named %s!"), *name_in.ToString());
+            start_time = end_time = 0;
+            return;
+        }
         
         std::pair<int32, int32> start_end_times = GetStartEndTimes(*json_clip, "bones");
         start_time = (float)start_end_times.first;
@@ -1120,11 +2573,191 @@ namespace CreatureModule {
 			(int32)end_time,
 			opacity_cache);
     }
+
+    void
+    CreatureAnimation::LoadFromBinaryData(const FName& name_in,
+                                          CreatureLoadDataPacket& load_data)
+    {
+        const TArray<FName>& names = load_data.binary_names;
+        const ClipEntry * clip = FindBinaryClip(load_data, name_in);
+        if(clip == NULL)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CreatureAnimation::LoadFromBinaryData() - No animation clip named %s!"), *name_in.ToString());
+            start_time = end_time = 0;
+            return;
+        }
+        
+        start_time = (float)clip->start_time;
+        end_time = (float)clip->end_time;
+        int32 num_frames = GetNumFrames(*clip);
+        
+        // bone animation
+        bones_cache.init(clip->start_time, clip->end_time);
+        if(clip->flags & ClipHasCompressedBones)
+        {
+            const BoneTrackEntry * track_entries = GetBinaryBlock<BoneTrackEntry>(load_data, clip->bone_tracks_offset);
+            TArray<FName> track_names;
+            TArray<meshBoneCompressedTrack> bone_tracks;
+            track_names.Reserve(clip->num_bone_tracks);
+            bone_tracks.SetNumZeroed(clip->num_bone_tracks);
+            
+            int32 num_track_keys = 0;
+            for(int32 i = 0; i < clip->num_bone_tracks; i++)
+            {
+                const BoneTrackEntry& cur_entry = track_entries[i];
+                track_names.Add(names[cur_entry.name_idx]);
+                bone_tracks[i].first_key = cur_entry.first_key;
+                bone_tracks[i].num_keys = cur_entry.num_keys;
+                FMemory::Memcpy(bone_tracks[i].bounds_min, cur_entry.bounds_min, sizeof(cur_entry.bounds_min));
+                FMemory::Memcpy(bone_tracks[i].bounds_step, cur_entry.bounds_step, sizeof(cur_entry.bounds_step));
+                num_track_keys = FMath::Max(num_track_keys, cur_entry.first_key + cur_entry.num_keys);
+            }
+            
+            const uint16 * track_frames = GetBinaryBlock<uint16>(load_data, clip->bone_track_frames_offset);
+            const uint16 * track_values = GetBinaryBlock<uint16>(load_data, clip->bone_track_values_offset);
+            bones_cache.setCompressedTracks(track_names,
+                                            bone_tracks,
+                                            TArray<uint16>(track_frames, num_track_keys),
+                                            TArray<uint16>(track_values, num_track_keys * 4));
+        }
+        else {
+            const FrameEntry * bone_frames = GetBinaryBlock<FrameEntry>(load_data, clip->bone_frames_offset);
+            const BoneKey * bone_keys = GetBinaryBlock<BoneKey>(load_data, clip->bone_keys_offset);
+            for(int32 i = 0; i < num_frames; i++)
+            {
+                TArray<meshBoneCache>& cache_list = bones_cache.getCacheTable()[i];
+                cache_list.Reserve(bone_frames[i].num_keys);
+                for(uint32 j = 0; j < bone_frames[i].num_keys; j++)
+                {
+                    const BoneKey& cur_key = bone_keys[bone_frames[i].first_key + j];
+                    meshBoneCache cache_data(names[cur_key.name_idx]);
+                    cache_data.setWorldStartPt(glm::vec4(cur_key.start_pt[0], cur_key.start_pt[1], 0, 1.0f));
+                    cache_data.setWorldEndPt(glm::vec4(cur_key.end_pt[0], cur_key.end_pt[1], 0, 1.0f));
+                    cache_list.Add(cache_data);
+                }
+            }
+            
+            bones_cache.makeAllReady();
+        }
+        
+        // mesh deformation animation
+        displacement_cache.init(clip->start_time, clip->end_time);
+        if(clip->flags & ClipHasDisplacementBasis)
+        {
+            const DisplacementTrackEntry * track_entries =
+                GetBinaryBlock<DisplacementTrackEntry>(load_data, clip->displacement_tracks_offset);
+            TArray<meshDisplacementBasisTrack> basis_tracks;
+            basis_tracks.SetNum(clip->num_displacement_tracks);
+            
+            int32 num_basis_values = 0;
+            int32 num_basis_coeffs = 0;
+            for(int32 i = 0; i < clip->num_displacement_tracks; i++)
+            {
+                const DisplacementTrackEntry& cur_entry = track_entries[i];
+                meshDisplacementBasisTrack& cur_track = basis_tracks[i];
+                cur_track.key = names[cur_entry.name_idx];
+                cur_track.num_local_pts = cur_entry.num_local_pts;
+                cur_track.num_post_pts = cur_entry.num_post_pts;
+                cur_track.num_basis = cur_entry.num_basis;
+                cur_track.basis_offset = cur_entry.basis_offset;
+                cur_track.coeffs_offset = cur_entry.coeffs_offset;
+                
+                const int32 num_vals = (cur_entry.num_local_pts + cur_entry.num_post_pts) * 2;
+                num_basis_values = FMath::Max(num_basis_values, cur_entry.basis_offset + ((cur_entry.num_basis + 1) * num_vals));
+                num_basis_coeffs = FMath::Max(num_basis_coeffs, cur_entry.coeffs_offset + (cur_entry.num_basis * clip->num_displacement_key_frames));
+            }
+            
+            const int32 * key_frames = GetBinaryBlock<int32>(load_data, clip->displacement_key_frames_offset);
+            const float * basis_values = GetBinaryBlock<float>(load_data, clip->displacement_basis_offset);
+            const float * basis_coeffs = GetBinaryBlock<float>(load_data, clip->displacement_coeffs_offset);
+            displacement_cache.setBasisTracks(TArray<int32>(key_frames, clip->num_displacement_key_frames),
+                                              basis_tracks,
+                                              TArray<float>(basis_values, num_basis_values),
+                                              TArray<float>(basis_coeffs, num_basis_coeffs));
+        }
+        else {
+            const FrameEntry * displacement_frames = GetBinaryBlock<FrameEntry>(load_data, clip->displacement_frames_offset);
+            const DisplacementKey * displacement_keys = GetBinaryBlock<DisplacementKey>(load_data, clip->displacement_keys_offset);
+            for(int32 i = 0; i < num_frames; i++)
+            {
+                TArray<meshDisplacementCache>& cache_list = displacement_cache.getCacheTable()[i];
+                cache_list.Reserve(displacement_frames[i].num_keys);
+                for(uint32 j = 0; j < displacement_frames[i].num_keys; j++)
+                {
+                    const DisplacementKey& cur_key = displacement_keys[displacement_frames[i].first_key + j];
+                    const glm::vec2 * read_pts = GetBinaryBlock<glm::vec2>(load_data, cur_key.pts_offset);
+                    
+                    meshDisplacementCache cache_data(names[cur_key.name_idx]);
+                    if(cur_key.num_local_pts > 0) {
+                        cache_data.setLocalDisplacements(TArray<glm::vec2>(read_pts, cur_key.num_local_pts));
+                    }
+                    
+                    if(cur_key.num_post_pts > 0) {
+                        cache_data.setPostDisplacements(TArray<glm::vec2>(read_pts + cur_key.num_local_pts, cur_key.num_post_pts));
+                    }
+                    
+                    cache_list.Add(cache_data);
+                }
+            }
+            
+            displacement_cache.makeAllReady();
+        }
+        
+        // uv swapping animation
+        const FrameEntry * uv_frames = GetBinaryBlock<FrameEntry>(load_data, clip->uv_frames_offset);
+        const UVWarpKey * uv_keys = GetBinaryBlock<UVWarpKey>(load_data, clip->uv_keys_offset);
+        uv_warp_cache.init(clip->start_time, clip->end_time);
+        for(int32 i = 0; i < num_frames; i++)
+        {
+            TArray<meshUVWarpCache>& cache_list = uv_warp_cache.getCacheTable()[i];
+            cache_list.Reserve(uv_frames[i].num_keys);
+            for(uint32 j = 0; j < uv_frames[i].num_keys; j++)
+            {
+                const UVWarpKey& cur_key = uv_keys[uv_frames[i].first_key + j];
+                meshUVWarpCache cache_data(names[cur_key.name_idx]);
+                cache_data.setEnabled(cur_key.enabled != 0);
+                cache_data.setLevel(cur_key.level);
+                cache_data.setUvWarpLocalOffset(glm::make_vec2(cur_key.local_offset));
+                cache_data.setUvWarpGlobalOffset(glm::make_vec2(cur_key.global_offset));
+                cache_data.setUvWarpScale(glm::make_vec2(cur_key.scale));
+                cache_list.Add(cache_data);
+            }
+        }
+        
+        uv_warp_cache.makeAllReady();
+        
+        // opacity animation
+        opacity_cache.init(clip->start_time, clip->end_time);
+        if((clip->flags & ClipHasOpacity) == 0)
+        {
+            return;
+        }
+        
+        const FrameEntry * opacity_frames = GetBinaryBlock<FrameEntry>(load_data, clip->opacity_frames_offset);
+        const OpacityKey * opacity_keys = GetBinaryBlock<OpacityKey>(load_data, clip->opacity_keys_offset);
+        for(int32 i = 0; i < num_frames; i++)
+        {
+            TArray<meshOpacityCache>& cache_list = opacity_cache.getCacheTable()[i];
+            cache_list.Reserve(opacity_frames[i].num_keys);
+            for(uint32 j = 0; j < opacity_frames[i].num_keys; j++)
+            {
+                const OpacityKey& cur_key = opacity_keys[opacity_frames[i].first_key + j];
+                meshOpacityCache cache_data(names[cur_key.name_idx]);
+                cache_data.setOpacity(cur_key.opacity);
+                cache_data.setRed(cur_key.red);
+                cache_data.setGreen(cur_key.green);
+                cache_data.setBlue(cur_key.blue);
+                cache_list.Add(cache_data);
+            }
+        }
+        
+        opacity_cache.makeAllReady();
+    }
     
     bool
     CreatureAnimation::hasCachePts() const
     {
-        return cache_pts.Num() > 0;
+        return (cache_pts.Num() > 0) || !compressed_cache_pts.isEmpty() || (bound_cache_num_frames > 0);
     }
     
     TArray<glm::float32 *>&
@@ -1142,23 +2775,136 @@ namespace CreatureModule {
 		}
 
 		cache_pts.Empty();
+		compressed_cache_pts.clear();
+
+		bound_cache_pts = nullptr;
+		bound_cache_num_frames = 0;
+		bound_cache_stride = 0;
+		cache_sample_frames.Empty();
+	}
+
+	void
+	CreatureAnimation::compressCachePts(int32 num_floats, int32 keyframe_interval)
+	{
+		if (cache_pts.Num() == 0)
+		{
+			return;
+		}
+
+		compressed_cache_pts.compress(cache_pts, num_floats, keyframe_interval);
+
+		for (int32 i = 0; i < cache_pts.Num(); i++)
+		{
+			delete[] cache_pts[i];
+		}
+
+		cache_pts.Empty();
+	}
+
+	CreatureCompressedPointCache&
+	CreatureAnimation::getCompressedCachePts()
+	{
+		return compressed_cache_pts;
+	}
+
+	void
+	CreatureAnimation::bindCachePts(const glm::float32 * frames_in, int32 num_frames, int32 stride)
+	{
+		clearCachePts();
+
+		bound_cache_pts = frames_in;
+		bound_cache_num_frames = (frames_in != nullptr) ? num_frames : 0;
+		bound_cache_stride = stride;
+	}
+
+	void
+	CreatureAnimation::unbindCachePts(const glm::float32 * frames_in)
+	{
+		if ((bound_cache_num_frames > 0) && (bound_cache_pts == frames_in))
+		{
+			clearCachePts();
+		}
+	}
+
+	const glm::float32 *
+	CreatureAnimation::getCacheFrame(int32 frame_idx) const
+	{
+		if (bound_cache_num_frames > 0)
+		{
+			return bound_cache_pts + (frame_idx * bound_cache_stride);
+		}
+
+		return cache_pts[frame_idx];
+	}
+
+	void
+	CreatureAnimation::setCacheSampleFrames(const TArray<int32>& frames_in)
+	{
+		cache_sample_frames = frames_in;
+	}
+
+	const TArray<int32>&
+	CreatureAnimation::getCacheSampleFrames() const
+	{
+		return cache_sample_frames;
+	}
+
+	int32
+	CreatureAnimation::getNumCachePts() const
+	{
+		if (!compressed_cache_pts.isEmpty())
+		{
+			return compressed_cache_pts.getNumFrames();
+		}
+
+		return (bound_cache_num_frames > 0) ? bound_cache_num_frames : cache_pts.Num();
 	}
     
     int32
     CreatureAnimation::getIndexByTime(int32 time_in) const
     {
         int32 retval = time_in - (int32)start_time;
-        retval = clipNum(retval, 0, (int32)cache_pts.Num() - 1);
+        retval = clipNum(retval, 0, getNumCachePts() - 1);
         
         return retval;
     }
     
+    void
+    CreatureAnimation::getCacheSamples(float time_in, int32& floor_idx, int32& ceil_idx, float& ratio) const
+    {
+        const int32 num_samples = getNumCachePts();
+        if((cache_sample_frames.Num() == 0) || (cache_sample_frames.Num() != num_samples))
+        {
+            floor_idx = getIndexByTime((int32)floorf(time_in));
+            ceil_idx = getIndexByTime((int32)ceilf(time_in));
+            ratio = (time_in - (float)floorf(time_in));
+            return;
+        }
+        
+        const float local_time = FMath::Clamp(time_in - start_time, 0.0f, (float)cache_sample_frames.Last());
+        const int32 upper_idx = Algo::UpperBound(cache_sample_frames, local_time);
+        floor_idx = FMath::Clamp(upper_idx - 1, 0, num_samples - 1);
+        ceil_idx = FMath::Min(upper_idx, num_samples - 1);
+        
+        const int32 span_frames = cache_sample_frames[ceil_idx] - cache_sample_frames[floor_idx];
+        ratio = (span_frames > 0) ? ((local_time - (float)cache_sample_frames[floor_idx]) / (float)span_frames) : 0.0f;
+    }
+    
     void
     CreatureAnimation::poseFromCachePts(float time_in, glm::float32 * target_pts, int32 num_pts)
     {
-        int32 cur_floor_time = getIndexByTime((int32)floorf(time_in));
-        int32 cur_ceil_time = getIndexByTime((int32)ceilf(time_in));
-        float cur_ratio = (time_in - (float)floorf(time_in));       
+        int32 cur_floor_time, cur_ceil_time;
+        float cur_ratio;
+        getCacheSamples(time_in, cur_floor_time, cur_ceil_time, cur_ratio);
+        
+        if(!compressed_cache_pts.isEmpty())
+        {
+            compressed_cache_pts.decode(cur_floor_time, cur_ceil_time, cur_ratio, target_pts, num_pts * 3);
+            return;
+        }
+        
+        const glm::float32 * floor_frame = getCacheFrame(cur_floor_time);
+        const glm::float32 * ceil_frame = getCacheFrame(cur_ceil_time);
         
 #ifdef CREATURE_MULTICORE
 		ParallelFor(num_pts, [&](int32 i) {
@@ -1166,8 +2912,8 @@ namespace CreatureModule {
 		for (int32 i = 0; i < num_pts; i++) {
 #endif
 			glm::float32 * set_pt = target_pts + (i * 3);
-			glm::float32 * floor_pts = cache_pts[cur_floor_time] + (i * 3);
-			glm::float32 * ceil_pts = cache_pts[cur_ceil_time] + (i * 3);
+			const glm::float32 * floor_pts = floor_frame + (i * 3);
+			const glm::float32 * ceil_pts = ceil_frame + (i * 3);
 
 			set_pt[0] = ((1.0f - cur_ratio) * floor_pts[0]) + (cur_ratio * ceil_pts[0]);
 			set_pt[1] = ((1.0f - cur_ratio) * floor_pts[1]) + (cur_ratio * ceil_pts[1]);
@@ -1186,7 +2932,8 @@ namespace CreatureModule {
         do_blending(false),
         blending_factor(0), mirror_y(false), use_custom_time_range(false),
         custom_start_time(0), custom_end_time(0), should_loop(true),
-        do_auto_blending(false), auto_blend_delta(0.1f), do_point_caching(false)
+        do_auto_blending(false), auto_blend_delta(0.1f), do_point_caching(false),
+        do_bone_space_blending(false), bones_only(false), compress_point_cache(false)
     {
         for(int32 i = 0; i < 2; i++) {
             blend_render_pts[i] = NULL;
@@ -1258,27 +3005,32 @@ namespace CreatureModule {
 
 	void 
 	CreatureManager::UpdateRegionSwitches(const FName& animation_name_in)
+	{
+		UpdateRegionSwitchesContext(*target_creature, animation_name_in);
+	}
+
+	void
+	CreatureManager::UpdateRegionSwitchesContext(Creature& pose_creature, const FName& animation_name_in)
 	{
 		if (animations.Contains(animation_name_in)) {
 			auto& cur_animation = animations[animation_name_in];
 
 			auto& displacement_cache_manager = cur_animation->getDisplacementCache();
-			TArray<meshDisplacementCache>& displacement_table =
-				displacement_cache_manager.getCacheTable()[0];
 
 			auto& uv_warp_cache_manager = cur_animation->getUVWarpCache();
 			TArray<meshUVWarpCache>& uv_swap_table =
 				uv_warp_cache_manager.getCacheTable()[0];
 
 			meshRenderBoneComposition * render_composition =
-				target_creature->GetRenderComposition();
+				pose_creature.GetRenderComposition();
 			TArray<meshRenderRegion *>& all_regions = render_composition->getRegions();
 
 			int32 index = 0;
 			for (auto& cur_region : all_regions) {
 				// Setup active or inactive displacements
-				bool use_local_displacements = (displacement_table[index].getLocalDisplacements().Num() > 0);
-				bool use_post_displacements = (displacement_table[index].getPostDisplacements().Num() > 0);
+				bool use_local_displacements = false;
+				bool use_post_displacements = false;
+				displacement_cache_manager.getDisplacementUsage(index, use_local_displacements, use_post_displacements);
 				cur_region->setUseLocalDisplacements(use_local_displacements);
 				cur_region->setUsePostDisplacements(use_post_displacements);
 
@@ -1331,7 +3083,11 @@ namespace CreatureModule {
     {
         do_blending = flag_in;
         
-        if(do_blending) {
+        if(!do_blending) {
+            // The last blended pose left the displacement switches of both clips on
+            UpdateRegionSwitches(active_animation_name);
+        }
+        else {
             if(blend_render_pts[0] == NULL) {
                 blend_render_pts[0] = new glm::float32[target_creature->GetTotalNumPoints() * 3];
             }
@@ -1392,6 +3148,26 @@ namespace CreatureModule {
 		return do_point_caching;
 	}
 
+	void CreatureManager::SetCompressPointCache(bool flag_in)
+	{
+		compress_point_cache = flag_in;
+	}
+
+	bool CreatureManager::GetCompressPointCache() const
+	{
+		return compress_point_cache;
+	}
+
+	void CreatureManager::SetBonesOnly(bool flag_in)
+	{
+		bones_only = flag_in;
+	}
+
+	bool CreatureManager::GetBonesOnly() const
+	{
+		return bones_only;
+	}
+
 	void 
 	CreatureManager::ResetBlendTime(const FName& name_in)
 	{
@@ -1424,6 +3200,18 @@ namespace CreatureModule {
         blending_factor = value_in;
     }
 
+	void
+	CreatureManager::SetBoneSpaceBlending(bool flag_in)
+	{
+		do_bone_space_blending = flag_in;
+	}
+
+	bool
+	CreatureManager::GetBoneSpaceBlending() const
+	{
+		return do_bone_space_blending;
+	}
+
 	void 
 	CreatureManager::ClearPointCache(const FName& animation_name_in)
 	{
@@ -1440,18 +3228,20 @@ namespace CreatureModule {
 	}
     
     void
-	CreatureManager::MakePointCache(const FName& animation_name_in, int32 gap_step)
+	CreatureManager::MakePointCache(const FName& animation_name_in, int32 gap_step, float max_error)
     {
+		SCOPE_CYCLE_COUNTER(STAT_CreatureManager_MakePointCache);
 		if (animations.Contains(animation_name_in) == false)
 		{
 			return;
 		}
 
-		if (gap_step < 1) {
+		// Adaptive sampling poses every frame, then drops the ones interpolation can stand in for
+		const bool adaptive_sampling = (max_error > 0);
+		if ((gap_step < 1) || adaptive_sampling) {
 			gap_step = 1;
 		}
 
-        float store_run_time = getRunTime();
         auto cur_animation = animations[animation_name_in];
         if(cur_animation->hasCachePts())
         {
@@ -1459,24 +3249,75 @@ namespace CreatureModule {
             return;
         }
         
-        TArray<glm::float32 *>& cache_pts_list = cur_animation->getCachePts();
-		int32 array_size = target_creature->GetTotalNumPoints() * 3;
-
-        UpdateRegionSwitches(animation_name_in);
-
-        //for(int32 i = (int32)cur_animation->getStartTime(); i <= (int32)cur_animation->getEndTime(); i++)
+		// Frames that actually get posed, the ones in between are interpolated afterwards
+		TArray<int32> sample_times;
+		TArray<int32> sample_steps;
 		int32 i = (int32)cur_animation->getStartTime();
 		while (true)
-        {
-            run_time = (float)i;
-			auto new_pts = new glm::float32[array_size];
-            PoseCreature(animation_name_in, new_pts, getRunTime());
-            
+		{
 			int32 real_step = gap_step;
 			if (i + real_step > cur_animation->getEndTime())
 			{
-				real_step = (int32)cur_animation->getEndTime() - i;
+				real_step = (int32)cur_animation->getEndTime() - i;
+			}
+
+			sample_times.Add(i);
+			sample_steps.Add(real_step);
+			i += real_step;
+
+			if (i > cur_animation->getEndTime() || real_step == 0)
+			{
+				break;
+			}
+		}
+
+		int32 array_size = target_creature->GetTotalNumPoints() * 3;
+		TArray<glm::float32 *> sample_pts;
+		sample_pts.SetNumUninitialized(sample_times.Num());
+		for (int32 j = 0; j < sample_times.Num(); j++)
+		{
+			sample_pts[j] = new glm::float32[array_size];
+		}
+
+		// Each pose context is a clone of the creature sharing its immutable mesh data,
+		// the bones override callback is user code so it keeps everything on one context
+		int32 num_contexts = 1;
+#ifdef CREATURE_MULTICORE
+		if (!bones_override_callback)
+		{
+			num_contexts = FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, 1, sample_times.Num());
+		}
+#endif
+		TArray<TSharedPtr<Creature> > pose_contexts;
+		for (int32 j = 0; j < num_contexts; j++)
+		{
+			pose_contexts.Add(MakeShareable(new Creature(*target_creature)));
+			UpdateRegionSwitchesContext(*pose_contexts[j], animation_name_in);
+		}
+
+#ifdef CREATURE_MULTICORE
+		ParallelFor(num_contexts, [&](int32 context_idx)
+		{
+#else
+		for (int32 context_idx = 0; context_idx < num_contexts; context_idx++)
+		{
+#endif
+			Creature& pose_creature = *pose_contexts[context_idx];
+			for (int32 j = context_idx; j < sample_times.Num(); j += num_contexts)
+			{
+				PoseCreatureContext(pose_creature, animation_name_in, sample_pts[j], (float)sample_times[j]);
 			}
+#ifdef CREATURE_MULTICORE
+		});
+#else
+		}
+#endif
+
+        TArray<glm::float32 *>& cache_pts_list = cur_animation->getCachePts();
+		for (int32 j = 0; j < sample_times.Num(); j++)
+		{
+			glm::float32 * new_pts = sample_pts[j];
+			int32 real_step = sample_steps[j];
 
 			bool firstCase = real_step > 1;
 			bool secondCase = (cache_pts_list.Num() >= 1);
@@ -1484,24 +3325,65 @@ namespace CreatureModule {
 			{
 				// fill in the gaps
 				glm::float32 * prev_pts = cache_pts_list[cache_pts_list.Num() - 1];
-				for (int32 j = 0; j < real_step; j++)
+				for (int32 k = 0; k < real_step; k++)
 				{
-					float factor = (float)j / (float)real_step;
+					float factor = (float)k / (float)real_step;
 					glm::float32 * gap_pts = interpFloatArray(prev_pts, new_pts, factor, array_size);
 					cache_pts_list.Add(gap_pts);
 				}
 			}
 
 			cache_pts_list.Add(new_pts);
-			i += real_step;
+		}
 
-			if (i > cur_animation->getEndTime() || real_step == 0)
+		if (adaptive_sampling && (cache_pts_list.Num() > 2))
+		{
+			// Greedily extend each span from its first sample as far as the error bound allows
+			TArray<int32> sample_frames;
+			sample_frames.Add(0);
+			int32 span_start = 0;
+			while (span_start < cache_pts_list.Num() - 1)
 			{
-				break;
+				int32 span_end = span_start + 1;
+				for (int32 j = span_start + 2;
+					(j < cache_pts_list.Num()) && (j - span_start <= MaxAdaptiveCacheGap);
+					j++)
+				{
+					if (!pointCacheSpanWithinError(cache_pts_list, span_start, j, array_size, max_error))
+					{
+						break;
+					}
+
+					span_end = j;
+				}
+
+				sample_frames.Add(span_end);
+				span_start = span_end;
 			}
-        }
-        
-        setRunTime(store_run_time);
+
+			TArray<glm::float32 *> kept_pts;
+			kept_pts.Reserve(sample_frames.Num());
+			int32 next_sample = 0;
+			for (int32 j = 0; j < cache_pts_list.Num(); j++)
+			{
+				if ((next_sample < sample_frames.Num()) && (sample_frames[next_sample] == j))
+				{
+					kept_pts.Add(cache_pts_list[j]);
+					next_sample++;
+				}
+				else {
+					delete[] cache_pts_list[j];
+				}
+			}
+
+			cache_pts_list = kept_pts;
+			cur_animation->setCacheSampleFrames(sample_frames);
+		}
+
+		if (compress_point_cache)
+		{
+			cur_animation->compressCachePts(array_size, PointCacheKeyframeInterval);
+		}
     }
     
 	glm::float32 * 
@@ -1517,10 +3399,49 @@ namespace CreatureModule {
 		return ret_array;
 	}
 
+	bool
+	CreatureManager::pointCacheSpanWithinError(const TArray<glm::float32 *>& frames, int32 start_idx, int32 end_idx,
+											   int32 array_size, float max_error) const
+	{
+		const float max_error_sq = max_error * max_error;
+		const glm::float32 * start_pts = frames[start_idx];
+		const glm::float32 * end_pts = frames[end_idx];
+		for (int32 i = start_idx + 1; i < end_idx; i++)
+		{
+			const float factor = (float)(i - start_idx) / (float)(end_idx - start_idx);
+			const glm::float32 * cur_pts = frames[i];
+			for (int32 j = 0; j < array_size; j += 3)
+			{
+				float error_sq = 0;
+				for (int32 k = 0; k < 3; k++)
+				{
+					const float interp_val = start_pts[j + k] + (factor * (end_pts[j + k] - start_pts[j + k]));
+					error_sq += FMath::Square(interp_val - cur_pts[j + k]);
+				}
+
+				if (error_sq > max_error_sq)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
     void
     CreatureManager::PoseCreature(const FName& animation_name_in,
                                   glm::float32 * target_pts,
 								  float input_run_time)
+    {
+		PoseCreatureContext(*target_creature, animation_name_in, target_pts, input_run_time);
+    }
+    
+    void
+    CreatureManager::PoseCreatureContext(Creature& pose_creature,
+                                         const FName& animation_name_in,
+                                         glm::float32 * target_pts,
+                                         float input_run_time)
     {
 		SCOPE_CYCLE_COUNTER(STAT_CreatureManager_PoseCreature);
         if(animations.Contains(animation_name_in) == false)
@@ -1539,7 +3460,7 @@ namespace CreatureModule {
 		auto& opacity_cache_manager = cur_animation->getOpacityCache();
         
         meshRenderBoneComposition * render_composition =
-        target_creature->GetRenderComposition();
+        pose_creature.GetRenderComposition();
         
         // Extract values from caches
         TMap<FName, meshBone *>& bones_map =
@@ -1548,9 +3469,9 @@ namespace CreatureModule {
         render_composition->getRegionsMap();
         
 		bone_cache_manager.retrieveValuesAtTime(input_run_time,
-                                                bones_map);
+                                                *render_composition);
 
-		AlterBonesByAnchor(bones_map, animation_name_in);
+		AlterBonesByAnchorContext(pose_creature, bones_map, animation_name_in);
         
         if(bones_override_callback)
         {
@@ -1579,6 +3500,338 @@ namespace CreatureModule {
 
     }
     
+	void
+	CreatureManager::PoseBlendSource(const FName& animation_name_in, float input_run_time)
+	{
+		auto& cur_animation = animations[animation_name_in];
+
+		meshRenderBoneComposition * render_composition =
+			target_creature->GetRenderComposition();
+		TMap<FName, meshBone *>& bones_map =
+			render_composition->getBonesMap();
+		TMap<FName, meshRenderRegion *>& regions_map =
+			render_composition->getRegionsMap();
+
+		UpdateRegionSwitches(animation_name_in);
+
+		cur_animation->getBonesCache().retrieveValuesAtTime(input_run_time,
+			*render_composition);
+		AlterBonesByAnchor(bones_map, animation_name_in);
+
+		cur_animation->getDisplacementCache().retrieveValuesAtTime(input_run_time,
+			regions_map);
+		cur_animation->getOpacityCache().retrieveValuesAtTime(input_run_time,
+			regions_map);
+	}
+
+	bool
+	CreatureManager::canBoneSpaceBlend() const
+	{
+		if (!do_bone_space_blending)
+		{
+			return false;
+		}
+
+		// Point cached animations skip skinning already, blend their points instead
+		if (do_point_caching)
+		{
+			for (int32 i = 0; i < 2; i++) {
+				if (animations[active_blend_animation_names[i]]->hasCachePts())
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void
+	CreatureManager::SetBlendGraph(const TArray<CreatureBlendClip>& clips_in,
+		const TArray<CreatureBlendLayer>& layers_in)
+	{
+		blend_graph_clips = clips_in;
+		blend_graph_layers = layers_in;
+	}
+
+	void
+	CreatureManager::SetBlendGraphClips(const TArray<CreatureBlendClip>& clips_in)
+	{
+		blend_graph_clips = clips_in;
+	}
+
+	void
+	CreatureManager::ClearBlendGraph()
+	{
+		if (HasBlendGraph())
+		{
+			UpdateRegionSwitches(active_animation_name);
+		}
+
+		blend_graph_clips.Reset();
+		blend_graph_layers.Reset();
+	}
+
+	bool
+	CreatureManager::HasBlendGraph() const
+	{
+		return blend_graph_clips.Num() > 0;
+	}
+
+	void
+	CreatureManager::increBlendGraphRuntimes(float delta_in)
+	{
+		// Every input keeps running, even while its weight is too small to be evaluated
+		TSet<FName> processed_names;
+		auto increName = [&](const FName& animation_name)
+		{
+			if (animations.Contains(animation_name) && !processed_names.Contains(animation_name))
+			{
+				float& cur_run_time = active_blend_run_times.FindOrAdd(animation_name);
+				cur_run_time = correctRunTime(cur_run_time + delta_in, animation_name);
+				processed_names.Add(animation_name);
+			}
+		};
+
+		for (auto& cur_clip : blend_graph_clips)
+		{
+			increName(cur_clip.animation_name);
+		}
+
+		for (auto& cur_layer : blend_graph_layers)
+		{
+			increName(cur_layer.animation_name);
+		}
+	}
+
+	const TArray<glm::vec4>&
+	CreatureManager::getAdditiveRefPts(const FName& animation_name_in)
+	{
+		TArray<glm::vec4> * ref_pts = blend_additive_ref_pts.Find(animation_name_in);
+		if (ref_pts)
+		{
+			return *ref_pts;
+		}
+
+		// Reference pose of an additive clip is its first frame
+		PoseBlendSource(animation_name_in, animations[animation_name_in]->getStartTime());
+
+		TArray<meshBone *>& bone_slots = target_creature->GetRenderComposition()->getBoneSlots();
+		TArray<glm::vec4>& new_pts = blend_additive_ref_pts.Add(animation_name_in);
+		new_pts.SetNumUninitialized(bone_slots.Num() * 2);
+		for (int32 i = 0; i < bone_slots.Num(); i++)
+		{
+			new_pts[i * 2] = bone_slots[i]->getWorldStartPt();
+			new_pts[i * 2 + 1] = bone_slots[i]->getWorldEndPt();
+		}
+
+		return new_pts;
+	}
+
+	void
+	CreatureManager::PoseBlendGraph(const TArray<CreatureBlendClip>& clips_in,
+		const TArray<CreatureBlendLayer>& layers_in,
+		glm::float32 * target_pts,
+		const TArray<float> * clip_run_times)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CreatureManager_PoseBlendGraph);
+		const float weight_epsilon = 0.001f;
+		check(!clip_run_times || (clip_run_times->Num() == clips_in.Num()));
+		auto getClipRunTime = [&](int32 clip_idx) -> float
+		{
+			return clip_run_times ?
+				(*clip_run_times)[clip_idx] :
+				active_blend_run_times.FindOrAdd(clips_in[clip_idx].animation_name);
+		};
+
+		// Normalise clip weights, dropping the ones that would not show
+		float total_weight = 0;
+		int32 heaviest_idx = INDEX_NONE;
+		for (int32 i = 0; i < clips_in.Num(); i++)
+		{
+			const CreatureBlendClip& cur_clip = clips_in[i];
+			if ((cur_clip.weight >= weight_epsilon) && animations.Contains(cur_clip.animation_name))
+			{
+				total_weight += cur_clip.weight;
+				if ((heaviest_idx == INDEX_NONE) || (cur_clip.weight > clips_in[heaviest_idx].weight))
+				{
+					heaviest_idx = i;
+				}
+			}
+		}
+
+		if (heaviest_idx == INDEX_NONE)
+		{
+			return;
+		}
+
+		meshRenderBoneComposition * render_composition =
+			target_creature->GetRenderComposition();
+		TArray<meshBone *>& bone_slots = render_composition->getBoneSlots();
+		TArray<meshRenderRegion *>& cur_regions = render_composition->getRegions();
+
+		blend_bone_pts.SetNumUninitialized(bone_slots.Num() * 2);
+		FMemory::Memzero(blend_bone_pts.GetData(), sizeof(glm::vec4) * blend_bone_pts.Num());
+		blend_local_displacements.SetNum(cur_regions.Num());
+		blend_post_displacements.SetNum(cur_regions.Num());
+		blend_region_colors.SetNumUninitialized(cur_regions.Num());
+		for (int32 i = 0; i < cur_regions.Num(); i++)
+		{
+			blend_local_displacements[i].Reset();
+			blend_post_displacements[i].Reset();
+			blend_region_colors[i] = glm::vec4(0);
+		}
+
+		// keep * accumulated + add * posed, regions without displacements count as zero
+		auto mixDisplacements = [](bool use_src, const TArray<glm::vec2>& src_displacements,
+			TArray<glm::vec2>& displacements, float keep_factor, float add_factor)
+		{
+			if (use_src && (displacements.Num() != src_displacements.Num())) {
+				displacements.SetNumZeroed(src_displacements.Num());
+			}
+
+			for (int32 j = 0; j < displacements.Num(); j++) {
+				displacements[j] *= keep_factor;
+				if (use_src) {
+					displacements[j] += src_displacements[j] * add_factor;
+				}
+			}
+		};
+
+		auto mixRegions = [&](float keep_factor, float add_factor)
+		{
+			for (int32 i = 0; i < cur_regions.Num(); i++)
+			{
+				meshRenderRegion * cur_region = cur_regions[i];
+				mixDisplacements(cur_region->getUseLocalDisplacements(), cur_region->getLocalDisplacements(),
+					blend_local_displacements[i], keep_factor, add_factor);
+				mixDisplacements(cur_region->getUsePostDisplacements(), cur_region->getPostDisplacements(),
+					blend_post_displacements[i], keep_factor, add_factor);
+
+				const glm::vec4 cur_color(cur_region->getOpacity(),
+					cur_region->getRed(),
+					cur_region->getGreen(),
+					cur_region->getBlue());
+				blend_region_colors[i] = (blend_region_colors[i] * keep_factor) + (cur_color * add_factor);
+			}
+		};
+
+		// Weighted sum of the clips
+		for (int32 clip_idx = 0; clip_idx < clips_in.Num(); clip_idx++)
+		{
+			const CreatureBlendClip& cur_clip = clips_in[clip_idx];
+			if ((cur_clip.weight < weight_epsilon) || !animations.Contains(cur_clip.animation_name))
+			{
+				continue;
+			}
+
+			const float cur_weight = cur_clip.weight / total_weight;
+			PoseBlendSource(cur_clip.animation_name, getClipRunTime(clip_idx));
+
+			for (int32 i = 0; i < bone_slots.Num(); i++)
+			{
+				blend_bone_pts[i * 2] += bone_slots[i]->getWorldStartPt() * cur_weight;
+				blend_bone_pts[i * 2 + 1] += bone_slots[i]->getWorldEndPt() * cur_weight;
+			}
+
+			mixRegions(1.0f, cur_weight);
+		}
+
+		// Layers
+		for (const CreatureBlendLayer& cur_layer : layers_in)
+		{
+			if ((cur_layer.weight < weight_epsilon) || !animations.Contains(cur_layer.animation_name))
+			{
+				continue;
+			}
+
+			const TArray<glm::vec4> * ref_pts = cur_layer.additive ? &getAdditiveRefPts(cur_layer.animation_name) : nullptr;
+			PoseBlendSource(cur_layer.animation_name, active_blend_run_times.FindOrAdd(cur_layer.animation_name));
+
+			const bool use_mask = (cur_layer.bone_mask.Num() > 0);
+			for (int32 i = 0; i < bone_slots.Num(); i++)
+			{
+				meshBone * cur_bone = bone_slots[i];
+				float cur_weight = cur_layer.weight;
+				if (use_mask)
+				{
+					const float * mask_weight = cur_layer.bone_mask.Find(cur_bone->getKey());
+					cur_weight = mask_weight ? (*mask_weight * cur_layer.weight) : 0.0f;
+				}
+
+				if (cur_weight < weight_epsilon)
+				{
+					continue;
+				}
+
+				glm::vec4& start_pt = blend_bone_pts[i * 2];
+				glm::vec4& end_pt = blend_bone_pts[i * 2 + 1];
+				if (ref_pts)
+				{
+					start_pt += (cur_bone->getWorldStartPt() - (*ref_pts)[i * 2]) * cur_weight;
+					end_pt += (cur_bone->getWorldEndPt() - (*ref_pts)[i * 2 + 1]) * cur_weight;
+				}
+				else {
+					start_pt = glm::mix(start_pt, cur_bone->getWorldStartPt(), cur_weight);
+					end_pt = glm::mix(end_pt, cur_bone->getWorldEndPt(), cur_weight);
+				}
+			}
+
+			if (!use_mask && !cur_layer.additive)
+			{
+				mixRegions(1.0f - cur_layer.weight, cur_layer.weight);
+			}
+		}
+
+		// Region switches and uv warps come from the heaviest clip
+		const FName& heaviest_name = clips_in[heaviest_idx].animation_name;
+		UpdateRegionSwitches(heaviest_name);
+		animations[heaviest_name]->getUVWarpCache().retrieveValuesAtTime(
+			getClipRunTime(heaviest_idx),
+			render_composition->getRegionsMap());
+
+		// Write out the blended pose
+		for (int32 i = 0; i < bone_slots.Num(); i++)
+		{
+			bone_slots[i]->setWorldStartPt(blend_bone_pts[i * 2]);
+			bone_slots[i]->setWorldEndPt(blend_bone_pts[i * 2 + 1]);
+		}
+
+		for (int32 i = 0; i < cur_regions.Num(); i++)
+		{
+			meshRenderRegion * cur_region = cur_regions[i];
+			cur_region->setUseLocalDisplacements(blend_local_displacements[i].Num() > 0);
+			if (cur_region->getUseLocalDisplacements()) {
+				cur_region->getLocalDisplacements() = blend_local_displacements[i];
+			}
+
+			cur_region->setUsePostDisplacements(blend_post_displacements[i].Num() > 0);
+			if (cur_region->getUsePostDisplacements()) {
+				cur_region->getPostDisplacements() = blend_post_displacements[i];
+			}
+
+			const glm::vec4& cur_color = blend_region_colors[i];
+			cur_region->setOpacity(cur_color.x);
+			cur_region->setRed(cur_color.y);
+			cur_region->setGreen(cur_color.z);
+			cur_region->setBlue(cur_color.w);
+		}
+
+		if (bones_override_callback)
+		{
+			bones_override_callback(render_composition->getBonesMap());
+		}
+
+		// Skin once
+		render_composition->updateAllTransforms(false);
+		for (auto j = 0; j < cur_regions.Num(); j++) {
+			meshRenderRegion * cur_region = cur_regions[j];
+
+			int32 cur_pt_index = cur_region->getStartPtIndex();
+			cur_region->poseFastFinalPts(target_pts + (cur_pt_index * 3));
+		}
+	}
+
     void
     CreatureManager::ProcessAutoBlending()
     {
@@ -1619,7 +3872,7 @@ namespace CreatureModule {
 			render_composition->getRegionsMap();
 
 		bone_cache_manager.retrieveValuesAtTime(input_run_time,
-			bones_map);
+			*render_composition);
 
 		AlterBonesByAnchor(bones_map, animation_name_in);
 
@@ -1701,14 +3954,19 @@ namespace CreatureModule {
 	}
 
 	void CreatureManager::AlterBonesByAnchor(TMap<FName, meshBone*>& bones_map, const FName & animation_name_in)
+	{
+		AlterBonesByAnchorContext(*target_creature, bones_map, animation_name_in);
+	}
+
+	void CreatureManager::AlterBonesByAnchorContext(Creature& pose_creature, TMap<FName, meshBone*>& bones_map, const FName & animation_name_in)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_CreatureManager_AlterBonesByAnchor);
-		if (target_creature->GetAnchorPointsActive() == false)
+		if (pose_creature.GetAnchorPointsActive() == false)
 		{
 			return;
 		}
 
-		auto anchor_point = target_creature->GetAnchorPoint(animation_name_in);
+		auto anchor_point = pose_creature.GetAnchorPoint(animation_name_in);
 		for (auto& cur_data : bones_map)
 		{
 			auto cur_bone = cur_data.Value;
@@ -1740,8 +3998,31 @@ namespace CreatureModule {
 			// process run times for blends
 			increAutoBlendRuntimes(delta * time_scale);
         }
+
+        if(bones_only)
+        {
+            if(HasBlendGraph())
+            {
+                increBlendGraphRuntimes(delta * time_scale);
+            }
+
+            PoseJustBones(active_animation_name, getRunTime());
+            return;
+        }
         
-        if(do_blending && checkAnimationBlendValid())
+        if(HasBlendGraph())
+        {
+            increBlendGraphRuntimes(delta * time_scale);
+            PoseBlendGraph(blend_graph_clips, blend_graph_layers, target_creature->GetRenderPts());
+        }
+        else if(do_blending && checkAnimationBlendValid() && canBoneSpaceBlend())
+        {
+            blend_pair_clips.SetNum(2);
+            blend_pair_clips[0] = CreatureBlendClip(active_blend_animation_names[0], 1.0f - blending_factor);
+            blend_pair_clips[1] = CreatureBlendClip(active_blend_animation_names[1], blending_factor);
+            PoseBlendGraph(blend_pair_clips, blend_graph_layers, target_creature->GetRenderPts());
+        }
+        else if(do_blending && checkAnimationBlendValid())
         {
             for(int32 i = 0; i < 2; i++) {
 				auto& cur_animation_name = active_blend_animation_names[i];
@@ -1782,6 +4063,35 @@ namespace CreatureModule {
             }
         }
 
+		FinishRenderPts();
+    }
+
+    void
+    CreatureManager::UpdateClips(float delta,
+                                 const TArray<CreatureBlendClip>& clips_in,
+                                 TArray<float>& run_times_in)
+    {
+        if(!is_playing || (clips_in.Num() != run_times_in.Num()))
+        {
+            return;
+        }
+
+        for(int32 i = 0; i < clips_in.Num(); i++)
+        {
+            if(animations.Contains(clips_in[i].animation_name))
+            {
+                run_times_in[i] = correctRunTime(run_times_in[i] + (delta * time_scale), clips_in[i].animation_name);
+            }
+        }
+
+        static const TArray<CreatureBlendLayer> no_layers;
+        PoseBlendGraph(clips_in, no_layers, target_creature->GetRenderPts(), &run_times_in);
+        FinishRenderPts();
+    }
+
+    void
+    CreatureManager::FinishRenderPts()
+    {
 		RunUVItemSwap();
         
         if(mirror_y)
@@ -1795,11 +4105,34 @@ namespace CreatureModule {
         }
     }
     
+    void
+    CreatureManager::AdvanceTime(float delta)
+    {
+        if(!is_playing)
+        {
+            return;
+        }
+        
+        increRunTime(delta * time_scale);
+    }
+    
+    bool
+    CreatureManager::IsPlayingSingleClip() const
+    {
+        return !HasBlendGraph() && !do_blending;
+    }
+    
     void
     CreatureManager::SetMirrorY(bool flag_in)
     {
         mirror_y = flag_in;
     }
+
+    bool
+    CreatureManager::GetMirrorY() const
+    {
+        return mirror_y;
+    }
     
     FName
     CreatureManager::IsContactBone(const glm::vec2& pt_in,
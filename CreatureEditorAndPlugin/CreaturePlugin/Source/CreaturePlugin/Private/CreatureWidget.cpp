@@ -26,7 +26,15 @@ void UCreatureWidget::InitCreatureCore()
 	if (creature_animation_asset
 		&& creature_core.creature_asset_filename != creature_animation_asset->GetCreatureFilename())
 	{
-		creature_core.pJsonData = &creature_animation_asset->GetJsonString();
+		creature_core.pBinaryData = creature_animation_asset->GetCompiledBinary();
+		if (creature_core.pBinaryData == nullptr)
+		{
+			creature_core.pZipJsonData = creature_animation_asset->GetCompressedJson();
+		}
+		if ((creature_core.pBinaryData == nullptr) && (creature_core.pZipJsonData == nullptr))
+		{
+			creature_core.pJsonData = &creature_animation_asset->GetJsonString();
+		}
 		creature_core.creature_asset_filename = creature_animation_asset->GetCreatureFilename();
 
 		creature_animation_asset->LoadPointCacheForAllClips(&creature_core);
@@ -0,0 +1,209 @@
+#include "CreatureWorldSubsystem.h"
+#include "CreaturePluginPCH.h"
+#include "CreatureMeshComponent.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "HAL/IConsoleManager.h"
+#include <Runtime/Core/Public/Async/ParallelFor.h>
+
+DECLARE_CYCLE_STAT(TEXT("CreatureWorld_RunBatch"), STAT_CreatureWorld_RunBatch, STATGROUP_Creature);
+DECLARE_CYCLE_STAT(TEXT("CreatureWorld_PublishBatch"), STAT_CreatureWorld_PublishBatch, STATGROUP_Creature);
+
+static TAutoConsoleVariable<int32> CVarCreatureBatchGrainSize(
+	TEXT("creature.BatchGrainSize"),
+	2,
+	TEXT("Number of creature components evaluated per task of the batched world update.\n")
+	TEXT("Larger values lower scheduling overhead, smaller values balance the load better."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarCreatureAnimLOD(
+	TEXT("creature.AnimLOD"),
+	-1,
+	TEXT("Animation LOD of creature components.\n")
+	TEXT("-1: per component setting\n")
+	TEXT("0: off for all components\n")
+	TEXT("1: on for all components"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarCreatureAnimLODBudgetMs(
+	TEXT("creature.AnimLODBudgetMs"),
+	0.0f,
+	TEXT("Time budget in ms per frame for all creature components using animation LOD, 0 disables the budget.\n")
+	TEXT("Over budget, the least significant components update less often."),
+	ECVF_Default);
+
+// Slowest update interval the budget hands out
+static const int32 MaxBudgetInterval = 8;
+
+void FCreatureBatchTickFunction::ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(FCreatureBatchTickFunction_ExecuteTick);
+	if (Target)
+	{
+		Target->RunBatch();
+		Target->ArbitrateAnimationLOD();
+	}
+}
+
+FString FCreatureBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FCreatureBatchTickFunction");
+}
+
+void UCreatureWorldSubsystem::Deinitialize()
+{
+	if (batch_tick_function.IsTickFunctionRegistered())
+	{
+		batch_tick_function.UnRegisterTickFunction();
+	}
+
+	queued_ticks.Reset();
+	lod_reports.Reset();
+	Super::Deinitialize();
+}
+
+void UCreatureWorldSubsystem::RegisterBatchTick()
+{
+	// Runs after all component ticks, same group the per component results used
+	if (batch_tick_function.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld * cur_world = GetWorld();
+	if (cur_world == nullptr || cur_world->PersistentLevel == nullptr)
+	{
+		return;
+	}
+
+	batch_tick_function.Target = this;
+	batch_tick_function.TickGroup = TG_PostPhysics;
+	batch_tick_function.bCanEverTick = true;
+	batch_tick_function.bStartWithTickEnabled = true;
+	// Only queued components are processed, so following the paused world is up to them
+	batch_tick_function.bTickEvenWhenPaused = true;
+	batch_tick_function.RegisterTickFunction(cur_world->PersistentLevel);
+}
+
+void UCreatureWorldSubsystem::QueueTick(UCreatureMeshComponent * component_in, float delta_time)
+{
+	RegisterBatchTick();
+	if (!batch_tick_function.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	FQueuedTick new_tick;
+	new_tick.component = component_in;
+	new_tick.delta_time = delta_time;
+	new_tick.cost = 0;
+	new_tick.can_tick = false;
+
+	auto cur_manager = component_in->GetCore().GetCreatureManager();
+	if (cur_manager && cur_manager->GetCreature())
+	{
+		new_tick.cost = cur_manager->GetCreature()->GetTotalNumPoints();
+	}
+
+	queued_ticks.Add(new_tick);
+}
+
+void UCreatureWorldSubsystem::RunBatch()
+{
+	if (queued_ticks.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CreatureWorld_RunBatch);
+
+		// Components can only go away on the game thread, so drop the dead ones before going wide
+		queued_ticks.RemoveAll([](const FQueuedTick& cur_tick)
+		{
+			return !cur_tick.component.IsValid();
+		});
+
+		// Heaviest first so the expensive characters do not end up last on one worker
+		queued_ticks.Sort([](const FQueuedTick& a, const FQueuedTick& b)
+		{
+			return a.cost > b.cost;
+		});
+
+		const int32 grain_size = FMath::Max(CVarCreatureBatchGrainSize.GetValueOnGameThread(), 1);
+		const int32 num_tasks = FMath::DivideAndRoundUp(queued_ticks.Num(), grain_size);
+
+		ParallelFor(num_tasks, [&](int32 i)
+		{
+			const int32 end_idx = FMath::Min((i + 1) * grain_size, queued_ticks.Num());
+			for (int32 j = i * grain_size; j < end_idx; j++)
+			{
+				FQueuedTick& cur_tick = queued_ticks[j];
+				cur_tick.can_tick = cur_tick.component.Get()->RunTickProcessing(cur_tick.delta_time, false);
+			}
+		});
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CreatureWorld_PublishBatch);
+		for (FQueuedTick& cur_tick : queued_ticks)
+		{
+			if (cur_tick.can_tick)
+			{
+				cur_tick.component.Get()->PublishCreatureCoreResult();
+			}
+		}
+	}
+
+	queued_ticks.Reset();
+}
+
+bool UCreatureWorldSubsystem::ShouldUseAnimationLOD(bool component_flag) const
+{
+	const int32 lod_mode = CVarCreatureAnimLOD.GetValueOnGameThread();
+	return (lod_mode < 0) ? component_flag : (lod_mode > 0);
+}
+
+void UCreatureWorldSubsystem::ReportAnimationLOD(UCreatureMeshComponent * component_in, float significance, float cost)
+{
+	RegisterBatchTick();
+
+	FLODReport new_report;
+	new_report.component = component_in;
+	new_report.significance = significance;
+	new_report.cost = cost;
+	lod_reports.Add(new_report);
+}
+
+void UCreatureWorldSubsystem::ArbitrateAnimationLOD()
+{
+	const float budget_ms = CVarCreatureAnimLODBudgetMs.GetValueOnGameThread();
+
+	// Most significant first, they get the budget before anyone else
+	lod_reports.Sort([](const FLODReport& a, const FLODReport& b)
+	{
+		return a.significance > b.significance;
+	});
+
+	float total_cost = 0;
+	for (const FLODReport& cur_report : lod_reports)
+	{
+		UCreatureMeshComponent * cur_component = cur_report.component.Get();
+		if (cur_component == nullptr)
+		{
+			continue;
+		}
+
+		total_cost += cur_report.cost;
+
+		int32 new_interval = 1;
+		if ((budget_ms > 0) && (total_cost > budget_ms))
+		{
+			new_interval = FMath::Clamp(FMath::CeilToInt(total_cost / budget_ms), 2, MaxBudgetInterval);
+		}
+
+		cur_component->SetLODBudgetInterval(new_interval);
+	}
+
+	lod_reports.Reset();
+}
@@ -37,6 +37,24 @@
 #include "CreaturePluginPCH.h"
 #include <math.h>
 #include <Runtime/Core/Public/Async/ParallelFor.h>
+#include "Misc/ScopeLock.h"
+#include "Math/VectorRegister.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarCreatureSimdSkinning(
+	TEXT("creature.SimdSkinning"),
+	1,
+	TEXT("Selects the dual quaternion skinning path for creature meshes.\n")
+	TEXT("0: scalar reference path\n")
+	TEXT("1: vectorized planar path, 4 vertices at a time"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarCreatureDirtyRegions(
+	TEXT("creature.DirtyRegions"),
+	0,
+	TEXT("Skips skinning creature regions whose influencing bones and displacements did not change since their last pose.\n")
+	TEXT("Keeps a copy of the last skinned points per region, so it only pays off for partially animated rigs."),
+	ECVF_Default);
 
 DECLARE_CYCLE_STAT(TEXT("MeshBoneCacheManager_retrieveValuesAtTime"), STAT_MeshBoneCacheManager_retrieveValuesAtTime, STATGROUP_Creature);
 DECLARE_CYCLE_STAT(TEXT("MeshOpacityCacheManager_retrieveValuesAtTime"), STAT_MeshOpacityCacheManager_retrieveValuesAtTime, STATGROUP_Creature);
@@ -259,6 +277,21 @@ meshBone::getAllChildren()
     return ret_data;
 }
 
+meshBone *
+meshBone::cloneHierarchy() const
+{
+    meshBone * ret_bone = new meshBone(*this);
+    ret_bone->parent = NULL;
+    ret_bone->children.Reset(children.Num());
+    for(auto i = 0; i < children.Num(); i++) {
+        meshBone * new_child = children[i]->cloneHierarchy();
+        new_child->parent = ret_bone;
+        ret_bone->children.Add(new_child);
+    }
+    
+    return ret_bone;
+}
+
 void meshBone::setRestParentMat(const glm::mat4& transform_in,
                                 glm::mat4 * inverse_in)
 {
@@ -371,10 +404,7 @@ void meshBone::setWorldEndPt(const glm::vec4& world_pt_in)
 
 void meshBone::fixDQs(const dualQuat& ref_dq)
 {
-    if( glm::dot(world_dq.real, ref_dq.real) < 0) {
-        world_dq.real = -world_dq.real;
-        world_dq.imaginary = -world_dq.imaginary;
-    }
+    fixDQ(ref_dq);
     
     for(auto i = 0; i < children.Num(); i++) {
         meshBone * cur_child = children[i];
@@ -382,6 +412,14 @@ void meshBone::fixDQs(const dualQuat& ref_dq)
     }
 }
 
+void meshBone::fixDQ(const dualQuat& ref_dq)
+{
+    if( glm::dot(world_dq.real, ref_dq.real) < 0) {
+        world_dq.real = -world_dq.real;
+        world_dq.imaginary = -world_dq.imaginary;
+    }
+}
+
 const glm::mat4&
 meshBone::getWorldDeltaMat() const
 {
@@ -408,44 +446,39 @@ meshBone::getWorldDq() const
 
 void meshBone::computeWorldDeltaTransforms()
 {
-    std::pair<glm::vec4, glm::vec4> calc = computeDirs(world_start_pt, world_end_pt);
-    glm::vec4 cur_tangent(calc.first.x, calc.first.y, 0, 0);
-    glm::vec4 cur_normal(calc.second.x, calc.second.y, 0, 0);
-    glm::vec4 cur_binormal(local_binormal_dir.x, local_binormal_dir.y, local_binormal_dir.z, 0);
-    
-//    std::cout<<"World Start Pt: "<<glm::to_string(world_start_pt)<<std::endl;
-    
-    glm::mat4 cur_rotate(cur_tangent, cur_normal, cur_binormal, glm::vec4(0,0,0,1));
-    glm::mat4 cur_translate =
-        glm::translate(glm::mat4(1.0),
-                   glm::vec3(world_start_pt.x, world_start_pt.y, 0));
-
-    world_delta_mat = (cur_translate * cur_rotate)
-                        * bind_world_inv_mat;
-    
-    
-//    glm::quat cur_quat = glm::normalize(glm::toQuat(world_delta_mat));
-    glm::quat cur_quat = glm::toQuat(world_delta_mat);
-    if(cur_quat.z < 0) {
-        //cur_quat = -cur_quat;
-    }
+    computeWorldDeltaTransform();
     
-
-    world_dq = dualQuat(cur_quat, glm::vec3(world_delta_mat[3]));
-//    std::cout<<"angle: "<<acos(world_dq.real.w) * 2.0 * (180.0 / M_PI)<<std::endl;
-//    std::cout<<"vector: "<<glm::to_string(glm::vec3(cur_quat.x, cur_quat.y, cur_quat.z))<<std::endl;
-
-/*
-    std::cout<<"cur_translate: "<<glm::to_string(cur_translate)<<std::endl;
-    std::cout<<"cur_rotate: "<<glm::to_string(cur_rotate)<<std::endl;
-    std::cout<<"Delta Mat: "<<glm::to_string(world_delta_mat)<<std::endl;
-*/
     for(auto i = 0; i < children.Num(); i++) {
         meshBone * cur_bone = children[i];
         cur_bone->computeWorldDeltaTransforms();
     }
 }
 
+void meshBone::computeWorldDeltaTransform()
+{
+    // The delta from the bind frame is a rotation about z by the change in bone angle
+    // followed by a translation, so build it from the angle instead of going through a mat4
+    const float delta_angle = atan2f(world_end_pt.y - world_start_pt.y, world_end_pt.x - world_start_pt.x) - world_rest_angle;
+    float half_sin, half_cos;
+    FMath::SinCos(&half_sin, &half_cos, delta_angle * 0.5f);
+    const float delta_cos = (half_cos * half_cos) - (half_sin * half_sin);
+    const float delta_sin = 2.0f * half_sin * half_cos;
+    
+    // Moves the rotated rest start point onto the current start point
+    const float trans_x = world_start_pt.x - ((delta_cos * world_rest_pos.x) - (delta_sin * world_rest_pos.y));
+    const float trans_y = world_start_pt.y - ((delta_sin * world_rest_pos.x) + (delta_cos * world_rest_pos.y));
+    
+    world_delta_mat = glm::mat4(1.0f);
+    world_delta_mat[0][0] = delta_cos;
+    world_delta_mat[0][1] = delta_sin;
+    world_delta_mat[1][0] = -delta_sin;
+    world_delta_mat[1][1] = delta_cos;
+    world_delta_mat[3][0] = trans_x;
+    world_delta_mat[3][1] = trans_y;
+    
+    world_dq = dualQuat(glm::quat(half_cos, 0, 0, half_sin), glm::vec3(trans_x, trans_y, 0));
+}
+
 const glm::mat4&
 meshBone::getRestParentMat() const
 {
@@ -612,6 +645,8 @@ meshRenderRegion::meshRenderRegion(glm::uint32 * indices_in,
     
     use_local_displacements = false;
     use_post_displacements = false;
+    last_pose_local = false;
+    last_pose_post = false;
     use_uv_warp = false;
     uv_warp_local_offset = glm::vec2(0,0);
     uv_warp_global_offset = glm::vec2(0,0);
@@ -628,6 +663,7 @@ meshRenderRegion::meshRenderRegion(glm::uint32 * indices_in,
 	red = 100.0f;
 	green = 100.0f;
 	blue = 100.0f;
+    weights_data = MakeShareable(new meshRenderRegionWeights());
 
     initUvWarp();
 }
@@ -635,6 +671,29 @@ meshRenderRegion::meshRenderRegion(glm::uint32 * indices_in,
 meshRenderRegion::~meshRenderRegion() {
 }
 
+meshRenderRegion *
+meshRenderRegion::clone(glm::uint32 * indices_in,
+                        glm::float32 * rest_pts_in,
+                        glm::float32 * uvs_in,
+                        meshBone * root_bone_in,
+                        const TMap<FName, meshBone *>& bones_map) const
+{
+    meshRenderRegion * ret_region = new meshRenderRegion(*this);
+    ret_region->store_indices = indices_in;
+    ret_region->store_rest_pts = rest_pts_in;
+    ret_region->store_uvs = uvs_in;
+    ret_region->determineMainBone(root_bone_in);
+    
+    // point the fast path at the new bones, the weights themselves are shared
+    ret_region->fast_bones_map.Reset(weights_data->fast_bone_keys.Num());
+    for(auto& cur_key : weights_data->fast_bone_keys)
+    {
+        ret_region->fast_bones_map.Add(bones_map[cur_key]);
+    }
+    
+    return ret_region;
+}
+
 void meshRenderRegion::setUVLevel(int32 value_in)
 {
 	uv_level = value_in;
@@ -693,13 +752,20 @@ glm::float32 * meshRenderRegion::getUVs() const
 TMap<FName, TArray<float> >&
 meshRenderRegion::getWeights()
 {
-    return normal_weight_map;
+    return weights_data->normal_weight_map;
 }
 
 void
 meshRenderRegion::renameWeightValuesByKey(const FName& old_key,
                                           const FName& new_key)
 {
+    // The keys of the influence table are renamed too, the dense weights are gone once it is built
+    const int32 key_index = weights_data->fast_bone_keys.IndexOfByKey(old_key);
+    if(key_index != INDEX_NONE) {
+        weights_data->fast_bone_keys[key_index] = new_key;
+    }
+    
+    TMap<FName, TArray<float> >& normal_weight_map = weights_data->normal_weight_map;
     if(normal_weight_map.Contains(old_key) == false)
     {
         return;
@@ -710,60 +776,377 @@ meshRenderRegion::renameWeightValuesByKey(const FName& old_key,
     normal_weight_map.Add(new_key, weight_values);
 }
 
+void
+meshRenderRegion::fillBoneWeights(const FName& bone_key, float * weights_out) const
+{
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    const TArray<meshBoneInfluence>& influences = weights_data->influences;
+    const TArray<uint8>& influence_counts = weights_data->influence_counts;
+    const int32 bone_index = weights_data->fast_bone_keys.IndexOfByKey(bone_key);
+    
+    FMemory::Memzero(weights_out, sizeof(float) * getNumPts());
+    if(bone_index == INDEX_NONE) {
+        return;
+    }
+    
+    for(auto i = 0; i < influence_counts.Num(); i++)
+    {
+        const meshBoneInfluence * pt_influences = influences.GetData() + (i * max_influences);
+        for(auto k = 0; k < influence_counts[i]; k++)
+        {
+            if(pt_influences[k].bone_index == bone_index) {
+                weights_out[i] = pt_influences[k].weight;
+                break;
+            }
+        }
+    }
+}
+
+const TArray<FName>&
+meshRenderRegion::getInfluenceBoneKeys() const
+{
+    return weights_data->fast_bone_keys;
+}
+
+const TArray<meshBoneInfluence>&
+meshRenderRegion::getInfluences() const
+{
+    return weights_data->influences;
+}
+
+const TArray<uint8>&
+meshRenderRegion::getInfluenceCounts() const
+{
+    return weights_data->influence_counts;
+}
+
+void
+meshRenderRegion::setInfluences(const TArray<FName>& bone_keys_in,
+                                TArray<meshBoneInfluence>&& influences_in,
+                                TArray<uint8>&& influence_counts_in)
+{
+    check(influences_in.Num() == influence_counts_in.Num() * meshRenderRegionWeights::max_influences);
+    weights_data->normal_weight_map.Empty();
+    weights_data->fast_bone_keys = bone_keys_in;
+    weights_data->influences = MoveTemp(influences_in);
+    weights_data->influence_counts = MoveTemp(influence_counts_in);
+    
+    fast_bones_map.Empty();
+    fill_dq_array.Empty();
+    fill_dq_array.SetNumZeroed(bone_keys_in.Num());
+    
+    initInfluenceBones();
+    initInfluenceClusters();
+    initSimdInfluences();
+}
+
 void
 meshRenderRegion::initFastNormalWeightMap(const TMap<FName, meshBone *>& bones_map)
 {
+    TArray<FName>& fast_bone_keys = weights_data->fast_bone_keys;
+    TArray<meshBoneInfluence>& influences = weights_data->influences;
+    TArray<uint8>& influence_counts = weights_data->influence_counts;
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    
+    if((weights_data->normal_weight_map.Num() == 0) && (influence_counts.Num() > 0)) {
+        // already built or loaded, the bones of a loaded table still need looking up
+        if(fast_bones_map.Num() != fast_bone_keys.Num()) {
+            fast_bones_map.Reset(fast_bone_keys.Num());
+            for(auto& cur_key : fast_bone_keys)
+            {
+                fast_bones_map.Add(bones_map[cur_key]);
+            }
+        }
+        
+        return;
+    }
+    
     fast_normal_weight_map.Empty();
     fast_bones_map.Empty();
-    reverse_fast_normal_weight_map.Empty();
-    relevant_bones_indices.Empty();
+    fast_bone_keys.Empty();
+    influences.Empty();
+    influence_counts.Empty();
     fill_dq_array.Empty();
     
+    check(bones_map.Num() <= MAX_uint16);
     for(auto& bone_data : bones_map)
     {
-        TArray<float> values = normal_weight_map[bone_data.Key];
+        TArray<float> values = weights_data->normal_weight_map[bone_data.Key];
         fast_normal_weight_map.Add(values);
         
         fast_bones_map.Add(bone_data.Value);
+        fast_bone_keys.Add(bone_data.Key);
+    }
+    
+    fill_dq_array.SetNumZeroed(bones_map.Num());
+    
+    int32 num_pts = (fast_normal_weight_map.Num() > 0) ? fast_normal_weight_map[0].Num() : 0;
+    influences.SetNumZeroed(num_pts * max_influences);
+    influence_counts.SetNumZeroed(num_pts);
+    
+    for(auto i = 0; i < num_pts; i++)
+    {
+        // keep the strongest influences above the cutoff
+        meshBoneInfluence * pt_influences = influences.GetData() + (i * max_influences);
+        int32 num_influences = 0;
+        const float cutoff_val = 0.05f;
+        for(auto j = 0; j < fast_normal_weight_map.Num(); j++)
+        {
+            float sample_val = fast_normal_weight_map[j][i];
+            if(sample_val <= cutoff_val)
+            {
+                continue;
+            }
+            
+            int32 write_index = num_influences;
+            if(num_influences == max_influences)
+            {
+                // full, replace the weakest if this one is stronger
+                write_index = 0;
+                for(auto k = 1; k < max_influences; k++)
+                {
+                    if(pt_influences[k].weight < pt_influences[write_index].weight) {
+                        write_index = k;
+                    }
+                }
+                
+                if(pt_influences[write_index].weight >= sample_val) {
+                    continue;
+                }
+            }
+            else {
+                num_influences++;
+            }
+            
+            pt_influences[write_index].bone_index = (uint16)j;
+            pt_influences[write_index].weight = sample_val;
+        }
+        
+        // strongest first, then renormalize
+        for(auto k = 1; k < num_influences; k++)
+        {
+            meshBoneInfluence cur_influence = pt_influences[k];
+            int32 m = k - 1;
+            while((m >= 0) && (pt_influences[m].weight < cur_influence.weight))
+            {
+                pt_influences[m + 1] = pt_influences[m];
+                m--;
+            }
+            
+            pt_influences[m + 1] = cur_influence;
+        }
+        
+        float total_weight = 0;
+        for(auto k = 0; k < num_influences; k++)
+        {
+            total_weight += pt_influences[k].weight;
+        }
         
-        if(reverse_fast_normal_weight_map.Num() == 0)
+        if(total_weight > 0)
         {
-            reverse_fast_normal_weight_map.SetNumZeroed(values.Num());
-            relevant_bones_indices.SetNumZeroed(values.Num());
+            for(auto k = 0; k < num_influences; k++)
+            {
+                pt_influences[k].weight /= total_weight;
+            }
         }
+        
+        influence_counts[i] = (uint8)num_influences;
     }
     
-    fill_dq_array.SetNumZeroed(bones_map.Num());
+    fast_normal_weight_map.Empty();
+    
+    // Everything reads the influence table from here on
+    weights_data->normal_weight_map.Empty();
+    
+    initInfluenceBones();
+    initInfluenceClusters();
+    initSimdInfluences();
+}
+
+void
+meshRenderRegion::initInfluenceBones()
+{
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    const TArray<meshBoneInfluence>& influences = weights_data->influences;
+    const TArray<uint8>& influence_counts = weights_data->influence_counts;
+    TArray<uint16>& influence_bone_indices = weights_data->influence_bone_indices;
+    
+    TBitArray<> is_used(false, weights_data->fast_bone_keys.Num());
+    for(auto i = 0; i < influence_counts.Num(); i++)
+    {
+        const meshBoneInfluence * pt_influences = influences.GetData() + (i * max_influences);
+        for(auto k = 0; k < influence_counts[i]; k++)
+        {
+            is_used[pt_influences[k].bone_index] = true;
+        }
+    }
     
-    for(auto i = 0; i < reverse_fast_normal_weight_map.Num(); i++)
+    influence_bone_indices.Empty();
+    for(TConstSetBitIterator<> it(is_used); it; ++it)
     {
-        // reverse normal weight map
-        TArray<float> new_values;
-        new_values.SetNumZeroed(fast_normal_weight_map.Num());
+        influence_bone_indices.Add((uint16)it.GetIndex());
+    }
+}
 
-        for(auto j = 0; j < fast_normal_weight_map.Num(); j++)
+void
+meshRenderRegion::initInfluenceClusters()
+{
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    const TArray<meshBoneInfluence>& influences = weights_data->influences;
+    const TArray<uint8>& influence_counts = weights_data->influence_counts;
+    TArray<meshBoneInfluence>& cluster_influences = weights_data->cluster_influences;
+    TArray<uint8>& cluster_influence_counts = weights_data->cluster_influence_counts;
+    TArray<int32>& pt_cluster_indices = weights_data->pt_cluster_indices;
+    
+    cluster_influences.Empty();
+    cluster_influence_counts.Empty();
+    pt_cluster_indices.Empty();
+    cluster_dqs.Empty();
+    
+    int32 num_pts = influence_counts.Num();
+    if(num_pts == 0) {
+        return;
+    }
+    
+    auto isSameInfluenceSet = [&](const meshBoneInfluence * set_a, const meshBoneInfluence * set_b, int32 num_influences)
+    {
+        for(auto k = 0; k < num_influences; k++)
         {
-            new_values[j]  = fast_normal_weight_map[j][i];
+            if((set_a[k].bone_index != set_b[k].bone_index)
+               || (set_a[k].weight != set_b[k].weight))
+            {
+                return false;
+            }
         }
         
-        reverse_fast_normal_weight_map[i] = new_values;
+        return true;
+    };
+    
+    TMultiMap<uint32, int32> cluster_lookup;
+    pt_cluster_indices.SetNumUninitialized(num_pts);
+    for(auto i = 0; i < num_pts; i++)
+    {
+        const meshBoneInfluence * pt_influences = influences.GetData() + (i * max_influences);
+        int32 num_influences = influence_counts[i];
         
-        // relevant bone indices
-        TArray<int32> relevant_array;
-        const float cutoff_val = 0.05f;
-        for(auto j = 0; j < fast_normal_weight_map.Num(); j++)
+        uint32 set_hash = GetTypeHash(num_influences);
+        for(auto k = 0; k < num_influences; k++)
         {
-            float sample_val = fast_normal_weight_map[j][i];
-            if(sample_val > cutoff_val)
+            set_hash = HashCombine(set_hash, GetTypeHash(pt_influences[k].bone_index));
+            set_hash = HashCombine(set_hash, GetTypeHash(pt_influences[k].weight));
+        }
+        
+        int32 found_cluster = INDEX_NONE;
+        TArray<int32> candidates;
+        cluster_lookup.MultiFind(set_hash, candidates);
+        for(auto cur_cluster : candidates)
+        {
+            if((cluster_influence_counts[cur_cluster] == num_influences)
+               && isSameInfluenceSet(cluster_influences.GetData() + (cur_cluster * max_influences), pt_influences, num_influences))
             {
-                relevant_array.Add((int32)j);
+                found_cluster = cur_cluster;
+                break;
             }
         }
         
-        relevant_bones_indices[i] = relevant_array;
+        if(found_cluster == INDEX_NONE)
+        {
+            found_cluster = cluster_influence_counts.Add((uint8)num_influences);
+            cluster_influences.Append(pt_influences, max_influences);
+            cluster_lookup.Add(set_hash, found_cluster);
+        }
+        
+        pt_cluster_indices[i] = found_cluster;
     }
     
-    fast_normal_weight_map.Empty();
+    // Only worth it when on average at least 2 vertices share each cluster
+    if((cluster_influence_counts.Num() * 2) > num_pts)
+    {
+        cluster_influences.Empty();
+        cluster_influence_counts.Empty();
+        pt_cluster_indices.Empty();
+    }
+}
+
+void
+meshRenderRegion::blendClusterDqs()
+{
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    const TArray<uint8>& cluster_influence_counts = weights_data->cluster_influence_counts;
+    const meshBoneInfluence * base_influences = weights_data->cluster_influences.GetData();
+    
+    cluster_dqs.SetNum(cluster_influence_counts.Num(), false);
+    for(auto i = 0; i < cluster_influence_counts.Num(); i++)
+    {
+        dualQuat accum_dq;
+        const meshBoneInfluence * cluster_influences = base_influences + (i * max_influences);
+        for(int32 j = 0; j < cluster_influence_counts[i]; j++)
+        {
+            float cur_weight_val = cluster_influences[j].weight;
+            accum_dq.add(fast_bones_map[cluster_influences[j].bone_index]->getWorldDq(), cur_weight_val, cur_weight_val);
+        }
+        
+        accum_dq.normalize();
+        cluster_dqs[i] = accum_dq;
+    }
+}
+
+void
+meshRenderRegion::initSimdInfluences()
+{
+    const int32 num_lanes = meshRenderRegionWeights::simd_lanes;
+    const int32 max_pt_influences = meshRenderRegionWeights::max_influences;
+    const TArray<meshBoneInfluence>& influences = weights_data->influences;
+    const TArray<uint8>& influence_counts = weights_data->influence_counts;
+    TArray<int32>& group_offsets = weights_data->simd_group_offsets;
+    TArray<int32>& bone_indices = weights_data->simd_bone_indices;
+    TArray<float>& weights = weights_data->simd_weights;
+    
+    group_offsets.Empty();
+    bone_indices.Empty();
+    weights.Empty();
+    
+    int32 num_pts = influence_counts.Num();
+    if((num_pts == 0) || (fill_dq_array.Num() == 0)) {
+        return;
+    }
+    
+    // Every group gets as many influence rows as its most influenced vertex,
+    // vertices with fewer influences are padded with zero weights
+    int32 num_groups = (num_pts + num_lanes - 1) / num_lanes;
+    group_offsets.Reserve(num_groups + 1);
+    for(auto i = 0; i < num_groups; i++)
+    {
+        group_offsets.Add(bone_indices.Num() / num_lanes);
+        
+        int32 max_influences = 0;
+        for(auto j = 0; j < num_lanes; j++)
+        {
+            int32 pt_index = (i * num_lanes) + j;
+            if(pt_index < num_pts) {
+                max_influences = FMath::Max(max_influences, (int32)influence_counts[pt_index]);
+            }
+        }
+        
+        for(auto k = 0; k < max_influences; k++)
+        {
+            for(auto j = 0; j < num_lanes; j++)
+            {
+                int32 pt_index = (i * num_lanes) + j;
+                if((pt_index < num_pts) && (k < influence_counts[pt_index])) {
+                    const meshBoneInfluence& cur_influence = influences[(pt_index * max_pt_influences) + k];
+                    bone_indices.Add(cur_influence.bone_index);
+                    weights.Add(cur_influence.weight);
+                }
+                else {
+                    bone_indices.Add(0);
+                    weights.Add(0);
+                }
+            }
+        }
+    }
+    
+    group_offsets.Add(bone_indices.Num() / num_lanes);
 }
 
 int32 meshRenderRegion::getNumPts() const
@@ -1065,19 +1448,12 @@ void meshRenderRegion::poseFinalPts(glm::float32 * output_pts,
         glm::mat4 accum_mat(0);
         dualQuat accum_dq;
         
-        int32 n_index = 0;
-        for(auto& cur_iter : bones_map)
+        const meshBoneInfluence * pt_influences =
+            weights_data->influences.GetData() + (i * meshRenderRegionWeights::max_influences);
+        for(auto k = 0; k < weights_data->influence_counts[i]; k++)
         {
-            const FName& cur_key = cur_iter.Key;
-            meshBone * cur_bone = cur_iter.Value;
-            float cur_weight_val = 0;
-            if(fast_normal_weight_map.Num() > 0) {
-                cur_weight_val = fast_normal_weight_map[n_index][i];
-            }
-            else {
-                cur_weight_val = normal_weight_map[cur_key][i];
-            }
-            
+            meshBone * cur_bone = fast_bones_map[pt_influences[k].bone_index];
+            float cur_weight_val = pt_influences[k].weight;
             float cur_im_weight_val = cur_weight_val;
             
             if(use_dq == false) {
@@ -1088,8 +1464,6 @@ void meshRenderRegion::poseFinalPts(glm::float32 * output_pts,
                 const dualQuat& world_dq = cur_bone->getWorldDq();
                 accum_dq.add(world_dq, cur_weight_val, cur_im_weight_val);
             }
-            
-            ++n_index;
         }
 
         glm::vec4 final_pt(0);
@@ -1126,16 +1500,131 @@ void meshRenderRegion::poseFastFinalPts(glm::float32 * output_pts,
 										bool try_local_displacements,
 										bool try_post_displacements,
 										bool try_uv_swap)
+{
+	const bool add_local = use_local_displacements && try_local_displacements;
+	const bool add_post = use_post_displacements && try_post_displacements;
+	const bool track_dirty = (CVarCreatureDirtyRegions.GetValueOnAnyThread() != 0);
+
+	if (track_dirty && !isPoseDirty(add_local, add_post))
+	{
+		FMemory::Memcpy(output_pts, last_pose_pts.GetData(), sizeof(glm::float32) * last_pose_pts.Num());
+	}
+	else {
+		if ((CVarCreatureSimdSkinning.GetValueOnAnyThread() != 0)
+			&& (weights_data->simd_group_offsets.Num() > 0))
+		{
+			poseFastFinalPtsSimd(output_pts, try_local_displacements, try_post_displacements);
+		}
+		else {
+			poseFastFinalPtsScalar(output_pts, try_local_displacements, try_post_displacements);
+		}
+
+		if (track_dirty) {
+			storePoseState(output_pts, add_local, add_post);
+		}
+		else {
+			last_pose_pts.Empty();
+		}
+	}
+
+	// uv warping
+	if (use_uv_warp && try_uv_swap) {
+		runUvWarp();
+	}
+}
+
+bool meshRenderRegion::isPoseDirty(bool add_local, bool add_post) const
+{
+	// Only the bones weighted onto this region can move its points
+	const TArray<uint16>& influence_bone_indices = weights_data->influence_bone_indices;
+	if ((last_pose_pts.Num() != getNumPts() * 3)
+		|| (last_pose_dqs.Num() != influence_bone_indices.Num())
+		|| (add_local != last_pose_local)
+		|| (add_post != last_pose_post))
+	{
+		return true;
+	}
+
+	for (auto i = 0; i < influence_bone_indices.Num(); i++)
+	{
+		if (FMemory::Memcmp(&fast_bones_map[influence_bone_indices[i]]->getWorldDq(), &last_pose_dqs[i], sizeof(dualQuat)) != 0)
+		{
+			return true;
+		}
+	}
+
+	auto displacementsChanged = [](const TArray<glm::vec2>& cur_displacements, const TArray<glm::vec2>& last_displacements)
+	{
+		return (cur_displacements.Num() != last_displacements.Num())
+			|| (FMemory::Memcmp(cur_displacements.GetData(), last_displacements.GetData(), sizeof(glm::vec2) * cur_displacements.Num()) != 0);
+	};
+
+	if (add_local && displacementsChanged(local_displacements, last_local_displacements))
+	{
+		return true;
+	}
+
+	if (add_post && displacementsChanged(post_displacements, last_post_displacements))
+	{
+		return true;
+	}
+
+	return false;
+}
+
+void meshRenderRegion::storePoseState(const glm::float32 * output_pts, bool add_local, bool add_post)
+{
+	last_pose_pts.SetNumUninitialized(getNumPts() * 3);
+	FMemory::Memcpy(last_pose_pts.GetData(), output_pts, sizeof(glm::float32) * last_pose_pts.Num());
+
+	const TArray<uint16>& influence_bone_indices = weights_data->influence_bone_indices;
+	last_pose_dqs.SetNumUninitialized(influence_bone_indices.Num());
+	for (auto i = 0; i < influence_bone_indices.Num(); i++)
+	{
+		last_pose_dqs[i] = fast_bones_map[influence_bone_indices[i]]->getWorldDq();
+	}
+
+	if (add_local) {
+		last_local_displacements = local_displacements;
+	}
+	else {
+		last_local_displacements.Reset();
+	}
+
+	if (add_post) {
+		last_post_displacements = post_displacements;
+	}
+	else {
+		last_post_displacements.Reset();
+	}
+
+	last_pose_local = add_local;
+	last_pose_post = add_post;
+}
+
+void meshRenderRegion::poseFastFinalPtsScalar(glm::float32 * output_pts,
+											  bool try_local_displacements,
+											  bool try_post_displacements)
 {
 	glm::float32 * base_read_pt = getRestPts();
 	glm::float32 * base_write_pt = output_pts;
     
-    // fill up dqs
-    for(auto i = 0; i < fill_dq_array.Num(); i++)
-    {
-        fill_dq_array[i] = fast_bones_map[i]->getWorldDq();
+    // fill up dqs, once per cluster if the vertices share influences
+    const int32 * pt_cluster_indices = weights_data->pt_cluster_indices.GetData();
+    if(pt_cluster_indices) {
+        blendClusterDqs();
+    }
+    else {
+        for(auto i = 0; i < fill_dq_array.Num(); i++)
+        {
+            fill_dq_array[i] = fast_bones_map[i]->getWorldDq();
+        }
     }
     
+    const int32 max_influences = meshRenderRegionWeights::max_influences;
+    const meshBoneInfluence * base_influences = weights_data->influences.GetData();
+    const uint8 * influence_counts = weights_data->influence_counts.GetData();
+    
     // pose points
 #ifdef CREATURE_MULTICORE
 	ParallelFor(getNumPts(), [&](int32 i) {
@@ -1151,21 +1640,23 @@ void meshRenderRegion::poseFastFinalPts(glm::float32 * output_pts,
             cur_rest_pt.y += local_displacements[i].y;
         }
         
-        glm::mat4 accum_mat(0);
         dualQuat accum_dq;
-        
-        const auto& weight_map_vals = reverse_fast_normal_weight_map[i];
-        const auto& bone_indices = relevant_bones_indices[i];
-        
-        for(auto j : bone_indices)
-        {
-            float cur_im_weight_val = weight_map_vals[j];
-            const dualQuat& world_dq = fill_dq_array[j];
-            accum_dq.add(world_dq, cur_im_weight_val, cur_im_weight_val);
+        if(pt_cluster_indices) {
+            accum_dq = cluster_dqs[pt_cluster_indices[i]];
         }
-        
+        else {
+            const meshBoneInfluence * pt_influences = base_influences + (i * max_influences);
+            for(int32 j = 0; j < influence_counts[i]; j++)
+            {
+                float cur_im_weight_val = pt_influences[j].weight;
+                const dualQuat& world_dq = fill_dq_array[pt_influences[j].bone_index];
+                accum_dq.add(world_dq, cur_im_weight_val, cur_im_weight_val);
+            }
+            
+            accum_dq.normalize();
+        }
+        
         glm::vec4 final_pt(0);
-        accum_dq.normalize();
         final_pt = glm::vec4(accum_dq.transform(glm::vec3(cur_rest_pt)), 1);
         
         write_pt[0] = final_pt.x;
@@ -1182,11 +1673,161 @@ void meshRenderRegion::poseFastFinalPts(glm::float32 * output_pts,
 #else
 	}
 #endif
-    
-    // uv warping
-	if (use_uv_warp && try_uv_swap) {
-        runUvWarp();
-    }
+}
+
+void meshRenderRegion::poseFastFinalPtsSimd(glm::float32 * output_pts,
+											bool try_local_displacements,
+											bool try_post_displacements)
+{
+	const meshRenderRegionWeights& cur_weights = *weights_data;
+	const int32 num_lanes = meshRenderRegionWeights::simd_lanes;
+	const int32 num_pts = getNumPts();
+	const int32 num_groups = cur_weights.simd_group_offsets.Num() - 1;
+	const bool add_local = use_local_displacements && try_local_displacements;
+	const bool add_post = use_post_displacements && try_post_displacements;
+	glm::float32 * base_read_pt = getRestPts();
+	glm::float32 * base_write_pt = output_pts;
+
+	// Bones only rotate about z and move in xy, so their dqs are planar: real is (w, 0, 0, z) and
+	// imaginary is (0, x, y, 0). Only those 4 floats are packed, blended and applied.
+	// Holds the blended cluster dqs when the vertices share influences, else the bone dqs.
+	const int32 dq_size = 4;
+	const int32 * pt_cluster_indices = cur_weights.pt_cluster_indices.GetData();
+	auto packDq = [](const dualQuat& dq_in, float * write_dq)
+	{
+		write_dq[0] = dq_in.real.w;
+		write_dq[1] = dq_in.real.z;
+		write_dq[2] = dq_in.imaginary.x;
+		write_dq[3] = dq_in.imaginary.y;
+	};
+
+	if (pt_cluster_indices)
+	{
+		blendClusterDqs();
+		fill_dq_values.SetNumUninitialized(cluster_dqs.Num() * dq_size);
+		for (auto i = 0; i < cluster_dqs.Num(); i++)
+		{
+			packDq(cluster_dqs[i], fill_dq_values.GetData() + (i * dq_size));
+		}
+	}
+	else {
+		fill_dq_values.SetNumUninitialized(fast_bones_map.Num() * dq_size);
+		for (auto i = 0; i < fast_bones_map.Num(); i++)
+		{
+			packDq(fast_bones_map[i]->getWorldDq(), fill_dq_values.GetData() + (i * dq_size));
+		}
+	}
+
+	const float * dq_values = fill_dq_values.GetData();
+	const VectorRegister two_vec = VectorSetFloat1(2.0f);
+	const VectorRegister min_length_vec = VectorSetFloat1(SMALL_NUMBER);
+
+	// pose points, one lane per vertex
+#ifdef CREATURE_MULTICORE
+	ParallelFor(num_groups, [&](int32 i) {
+#else
+	for (int32 i = 0; i < num_groups; i++) {
+#endif
+		const int32 base_index = i * num_lanes;
+		const int32 num_active = FMath::Min(num_lanes, num_pts - base_index);
+
+		// accum[c] holds planar dq component c for all lanes
+		VectorRegister accum[4];
+		if (pt_cluster_indices)
+		{
+			// already blended, inactive lanes just repeat the last vertex
+			const float * lane_dqs[4];
+			for (int32 j = 0; j < num_lanes; j++)
+			{
+				lane_dqs[j] = dq_values + (pt_cluster_indices[base_index + FMath::Min(j, num_active - 1)] * dq_size);
+			}
+
+			for (int32 c = 0; c < dq_size; c++)
+			{
+				accum[c] = VectorSet(lane_dqs[0][c], lane_dqs[1][c], lane_dqs[2][c], lane_dqs[3][c]);
+			}
+		}
+		else {
+			// blend dqs
+			for (int32 c = 0; c < dq_size; c++)
+			{
+				accum[c] = VectorZero();
+			}
+
+			for (int32 k = cur_weights.simd_group_offsets[i]; k < cur_weights.simd_group_offsets[i + 1]; k++)
+			{
+				const int32 * bone_indices = cur_weights.simd_bone_indices.GetData() + (k * num_lanes);
+				const VectorRegister weight_vec = VectorLoad(cur_weights.simd_weights.GetData() + (k * num_lanes));
+				const float * dq_0 = dq_values + (bone_indices[0] * dq_size);
+				const float * dq_1 = dq_values + (bone_indices[1] * dq_size);
+				const float * dq_2 = dq_values + (bone_indices[2] * dq_size);
+				const float * dq_3 = dq_values + (bone_indices[3] * dq_size);
+
+				for (int32 c = 0; c < dq_size; c++)
+				{
+					accum[c] = VectorMultiplyAdd(weight_vec, VectorSet(dq_0[c], dq_1[c], dq_2[c], dq_3[c]), accum[c]);
+				}
+			}
+		}
+
+		// gather rest points, z does not change under a rotation about z
+		float read_x[4] = { 0, 0, 0, 0 }, read_y[4] = { 0, 0, 0, 0 };
+		for (int32 j = 0; j < num_active; j++)
+		{
+			const glm::float32 * read_pt = base_read_pt + ((base_index + j) * 3);
+			read_x[j] = read_pt[0];
+			read_y[j] = read_pt[1];
+
+			if (add_local) {
+				read_x[j] += local_displacements[base_index + j].x;
+				read_y[j] += local_displacements[base_index + j].y;
+			}
+		}
+
+		const VectorRegister p_x = VectorLoad(read_x);
+		const VectorRegister p_y = VectorLoad(read_y);
+		const VectorRegister& r_w = accum[0];
+		const VectorRegister& r_z = accum[1];
+		const VectorRegister& i_x = accum[2];
+		const VectorRegister& i_y = accum[3];
+
+		// Normalizing divides both parts by the real length, every term below is quadratic
+		// so a single 1 / |real|^2 takes care of it
+		const VectorRegister length_sq = VectorMultiplyAdd(r_w, r_w, VectorMultiply(r_z, r_z));
+		const VectorRegister inv_length_sq = VectorReciprocalAccurate(VectorMax(length_sq, min_length_vec));
+
+		// rotation by the angle of (w, z) doubled: cos = w^2 - z^2, sin = 2wz
+		const VectorRegister rot_cos = VectorMultiply(VectorSubtract(VectorMultiply(r_w, r_w), VectorMultiply(r_z, r_z)), inv_length_sq);
+		const VectorRegister rot_sin = VectorMultiply(VectorMultiply(two_vec, VectorMultiply(r_w, r_z)), inv_length_sq);
+
+		// translation: 2 * (ve * w + cross(v0, ve)) with v0 = (0, 0, z), ve = (x, y, 0)
+		const VectorRegister trans_x = VectorMultiply(VectorMultiply(two_vec, VectorSubtract(VectorMultiply(i_x, r_w), VectorMultiply(r_z, i_y))), inv_length_sq);
+		const VectorRegister trans_y = VectorMultiply(VectorMultiply(two_vec, VectorMultiplyAdd(i_y, r_w, VectorMultiply(r_z, i_x))), inv_length_sq);
+
+		const VectorRegister final_x = VectorAdd(VectorSubtract(VectorMultiply(rot_cos, p_x), VectorMultiply(rot_sin, p_y)), trans_x);
+		const VectorRegister final_y = VectorAdd(VectorMultiplyAdd(rot_sin, p_x, VectorMultiply(rot_cos, p_y)), trans_y);
+
+		float write_x[4], write_y[4];
+		VectorStore(final_x, write_x);
+		VectorStore(final_y, write_y);
+
+		for (int32 j = 0; j < num_active; j++)
+		{
+			glm::float32 * write_pt = base_write_pt + ((base_index + j) * 3);
+			write_pt[0] = write_x[j];
+			write_pt[1] = write_y[j];
+			write_pt[2] = 0;
+
+			if (add_post) {
+				write_pt[0] += post_displacements[base_index + j].x;
+				write_pt[1] += post_displacements[base_index + j].y;
+			}
+		}
+#ifdef CREATURE_MULTICORE
+	});
+#else
+	}
+#endif
 }
 
 // meshRenderBoneComposition
@@ -1227,7 +1868,7 @@ void meshRenderBoneComposition::setRootBone(meshBone * root_bone_in)
 }
 
 meshBone *
-meshRenderBoneComposition::getRootBone()
+meshRenderBoneComposition::getRootBone() const
 {
     return root_bone;
 }
@@ -1235,6 +1876,19 @@ meshRenderBoneComposition::getRootBone()
 void meshRenderBoneComposition::initBoneMap()
 {
     bones_map = meshRenderBoneComposition::genBoneMap(root_bone);
+    
+    bone_slots = root_bone->getAllChildren();
+    bone_slot_layout = MakeShareable(new TMap<FName, int32>());
+    for(auto i = 0; i < bone_slots.Num(); i++) {
+        bone_slot_layout->Add(bone_slots[i]->getKey(), i);
+    }
+    cache_bone_slots.Empty();
+    
+    bone_parent_slots.SetNumUninitialized(bone_slots.Num());
+    for(auto i = 0; i < bone_slots.Num(); i++) {
+        meshBone * parent_bone = bone_slots[i]->getParent();
+        bone_parent_slots[i] = parent_bone ? bone_slot_layout->FindChecked(parent_bone->getKey()) : -1;
+    }
 }
 
 TMap<FName, meshBone *>
@@ -1266,6 +1920,51 @@ meshRenderBoneComposition::getBonesMap()
     return bones_map;
 }
 
+TArray<meshBone *>&
+meshRenderBoneComposition::getBoneSlots()
+{
+    return bone_slots;
+}
+
+const TArray<int32>&
+meshRenderBoneComposition::getBoneParentSlots() const
+{
+    return bone_parent_slots;
+}
+
+const TSharedPtr<TMap<FName, int32> >&
+meshRenderBoneComposition::getBoneSlotLayout() const
+{
+    return bone_slot_layout;
+}
+
+void
+meshRenderBoneComposition::setBoneSlotLayout(const TSharedPtr<TMap<FName, int32> >& layout_in)
+{
+    bone_slot_layout = layout_in;
+    cache_bone_slots.Empty();
+}
+
+const TArray<int32>&
+meshRenderBoneComposition::getCacheBoneSlots(const meshBoneCacheManager& cache_in)
+{
+    const uint32 cache_id = cache_in.getFlatKeysId();
+    const TArray<int32> * found_slots = cache_bone_slots.Find(cache_id);
+    if(found_slots) {
+        return *found_slots;
+    }
+    
+    const TArray<FName>& flat_bone_keys = cache_in.getFlatBoneKeys();
+    TArray<int32>& new_slots = cache_bone_slots.Add(cache_id);
+    new_slots.SetNumUninitialized(flat_bone_keys.Num());
+    for(auto i = 0; i < flat_bone_keys.Num(); i++) {
+        const int32 * found_slot = bone_slot_layout->Find(flat_bone_keys[i]);
+        new_slots[i] = found_slot ? *found_slot : -1;
+    }
+    
+    return new_slots;
+}
+
 TMap<FName, meshRenderRegion *>&
 meshRenderBoneComposition::getRegionsMap()
 {
@@ -1284,8 +1983,22 @@ void meshRenderBoneComposition::updateAllTransforms(bool update_parent_xf)
         getRootBone()->computeParentTransforms();
     }
     
-    getRootBone()->computeWorldDeltaTransforms();
-    getRootBone()->fixDQs(getRootBone()->getWorldDq());
+    if(bone_parent_slots.Num() != bone_slots.Num()) {
+        getRootBone()->computeWorldDeltaTransforms();
+        getRootBone()->fixDQs(getRootBone()->getWorldDq());
+        return;
+    }
+    
+    // One linear pass, parents are always done before their children
+    for(auto i = 0; i < bone_slots.Num(); i++) {
+        meshBone * cur_bone = bone_slots[i];
+        cur_bone->computeWorldDeltaTransform();
+        
+        const int32 parent_slot = bone_parent_slots[i];
+        if(parent_slot >= 0) {
+            cur_bone->fixDQ(bone_slots[parent_slot]->getWorldDq());
+        }
+    }
 }
 
 void
@@ -1381,10 +2094,68 @@ meshUVWarpCache::getUvWarpScale() const
     return uv_warp_scale;
 }
 
+// Moves the rows of a per frame cache table that hold keys to the front and drops the rest.
+// Records the frame of each key and, per frame, the last key at or before it (-1 for none).
+template <typename T>
+static void compactCacheKeys(TArray<TArray<T> >& cache_table,
+                             TArray<int32>& key_frames,
+                             TArray<int32>& frame_keys)
+{
+    key_frames.Reset();
+    frame_keys.SetNumUninitialized(cache_table.Num());
+    
+    int32 num_keys = 0;
+    for(auto i = 0; i < cache_table.Num(); i++) {
+        if(cache_table[i].Num() > 0) {
+            if(num_keys != i) {
+                cache_table[num_keys] = MoveTemp(cache_table[i]);
+            }
+            
+            key_frames.Add(i);
+            num_keys++;
+        }
+        
+        frame_keys[i] = num_keys - 1;
+    }
+    
+    cache_table.SetNum(num_keys);
+    cache_table.Shrink();
+}
+
+// Finds the keys around a frame offset and the blend factor between them.
+// Offsets before the first key or after the last one hold that key.
+static bool findCacheKeys(const TArray<int32>& key_frames,
+                          const TArray<int32>& frame_keys,
+                          float local_time,
+                          int32& base_key,
+                          int32& end_key,
+                          float& ratio)
+{
+    if(key_frames.Num() == 0) {
+        return false;
+    }
+    
+    local_time = clipNumber(local_time, 0.0f, (float)(frame_keys.Num() - 1));
+    base_key = FMath::Max(frame_keys[(int32)floorf(local_time)], 0);
+    end_key = FMath::Min(base_key + 1, key_frames.Num() - 1);
+    
+    const float base_frame = (float)key_frames[base_key];
+    if((end_key == base_key) || (local_time <= base_frame)) {
+        end_key = base_key;
+        ratio = 0;
+    }
+    else {
+        ratio = (local_time - base_frame) / ((float)key_frames[end_key] - base_frame);
+    }
+    
+    return true;
+}
+
 // meshBoneCacheManager
 meshBoneCacheManager::meshBoneCacheManager()
 {
     is_ready = false;
+    flat_keys_id = 0;
 }
 
 meshBoneCacheManager::~meshBoneCacheManager()
@@ -1409,6 +2180,16 @@ meshBoneCacheManager::init(int32 start_time_in, int32 end_time_in)
     }
     
     is_ready = false;
+    
+    setFlatBoneKeys(TArray<FName>());
+    flat_cache.Empty();
+    
+    key_frames.Empty();
+    frame_keys.Empty();
+    
+    compressed_tracks.Empty();
+    compressed_frames.Empty();
+    compressed_values.Empty();
 }
 
 void
@@ -1417,6 +2198,89 @@ meshBoneCacheManager::makeAllReady()
     for(auto i = 0; i < bone_cache_data_ready.Num(); i++) {
         bone_cache_data_ready[i] = true;
     }
+    
+    if(frame_keys.Num() == 0) {
+        compactCacheKeys(bone_cache_table, key_frames, frame_keys);
+    }
+    
+    buildFlatCache();
+}
+
+void
+meshBoneCacheManager::buildFlatCache()
+{
+    if(bone_cache_table.Num() == 0) {
+        return;
+    }
+    
+    // Every key has to list the same bones in the same order to be flattened
+    const TArray<meshBoneCache>& first_frame = bone_cache_table[0];
+    for(auto& cur_frame : bone_cache_table)
+    {
+        if(cur_frame.Num() != first_frame.Num()) {
+            return;
+        }
+        
+        for(auto j = 0; j < cur_frame.Num(); j++) {
+            if(cur_frame[j].getKey() != first_frame[j].getKey()) {
+                return;
+            }
+        }
+    }
+    
+    int32 num_bones = first_frame.Num();
+    TArray<FName> new_keys;
+    new_keys.Reserve(num_bones);
+    for(auto& cur_cache : first_frame) {
+        new_keys.Add(cur_cache.getKey());
+    }
+    
+    setFlatBoneKeys(new_keys);
+    
+    flat_cache.SetNumUninitialized(bone_cache_table.Num() * num_bones * 4);
+    float * write_vals = flat_cache.GetData();
+    for(auto& cur_frame : bone_cache_table)
+    {
+        for(auto& cur_cache : cur_frame)
+        {
+            write_vals[0] = cur_cache.getWorldStartPt().x;
+            write_vals[1] = cur_cache.getWorldStartPt().y;
+            write_vals[2] = cur_cache.getWorldEndPt().x;
+            write_vals[3] = cur_cache.getWorldEndPt().y;
+            write_vals += 4;
+        }
+    }
+    
+    // The key table is not needed anymore
+    bone_cache_table.Empty();
+}
+
+void
+meshBoneCacheManager::setFlatBoneKeys(const TArray<FName>& keys_in)
+{
+    // Compositions key the bone slots they resolved by this id, so it must never be reused
+    static int32 last_flat_keys_id = 0;
+    
+    flat_bone_keys = keys_in;
+    flat_keys_id = (uint32)FPlatformAtomics::InterlockedIncrement(&last_flat_keys_id);
+}
+
+uint32
+meshBoneCacheManager::getFlatKeysId() const
+{
+    return flat_keys_id;
+}
+
+const TArray<FName>&
+meshBoneCacheManager::getFlatBoneKeys() const
+{
+    return flat_bone_keys;
+}
+
+const TArray<float>&
+meshBoneCacheManager::getFlatCache() const
+{
+    return flat_cache;
 }
 
 TArray<TArray<meshBoneCache> >&
@@ -1425,6 +2289,222 @@ meshBoneCacheManager::getCacheTable()
     return bone_cache_table;
 }
 
+bool
+meshBoneCacheManager::getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const
+{
+    return findCacheKeys(key_frames, frame_keys, time_in - (float)start_time, base_key, end_key, ratio);
+}
+
+const TArray<int32>&
+meshBoneCacheManager::getKeyFrames() const
+{
+    return key_frames;
+}
+
+bool
+meshBoneCacheManager::compressTracks(float tolerance_in)
+{
+    if((tolerance_in <= 0) || (flat_cache.Num() == 0) || (key_frames.Last() > MAX_uint16)) {
+        return false;
+    }
+    
+    const int32 num_bones = flat_bone_keys.Num();
+    const int32 num_keys = key_frames.Num();
+    const int32 row_size = num_bones * 4;
+    
+    TArray<meshBoneCompressedTrack> new_tracks;
+    TArray<uint16> new_frames;
+    TArray<uint16> new_values;
+    new_tracks.SetNumZeroed(num_bones);
+    
+    TArray<int32> kept_keys;
+    for(auto i = 0; i < num_bones; i++) {
+        auto readKey = [&](int32 key_idx)
+        {
+            return flat_cache.GetData() + (key_idx * row_size) + (i * 4);
+        };
+        
+        // Quantize against the bounds of the whole track
+        meshBoneCompressedTrack& cur_track = new_tracks[i];
+        float bounds_max[4];
+        for(auto j = 0; j < 4; j++) {
+            cur_track.bounds_min[j] = bounds_max[j] = readKey(0)[j];
+        }
+        
+        for(auto k = 1; k < num_keys; k++) {
+            const float * cur_vals = readKey(k);
+            for(auto j = 0; j < 4; j++) {
+                cur_track.bounds_min[j] = FMath::Min(cur_track.bounds_min[j], cur_vals[j]);
+                bounds_max[j] = FMath::Max(bounds_max[j], cur_vals[j]);
+            }
+        }
+        
+        for(auto j = 0; j < 4; j++) {
+            cur_track.bounds_step[j] = (bounds_max[j] - cur_track.bounds_min[j]) / (float)MAX_uint16;
+        }
+        
+        // Leave room for the rounding error of the quantized points
+        const float quantize_error = 0.5f * FMath::Max(
+            FMath::Sqrt(FMath::Square(cur_track.bounds_step[0]) + FMath::Square(cur_track.bounds_step[1])),
+            FMath::Sqrt(FMath::Square(cur_track.bounds_step[2]) + FMath::Square(cur_track.bounds_step[3])));
+        const float key_tolerance = FMath::Max(tolerance_in - quantize_error, 0.0f);
+        const float key_tolerance_sq = key_tolerance * key_tolerance;
+        
+        auto pointsWithinError = [&](const float * vals_a, const float * vals_b)
+        {
+            return (FMath::Square(vals_a[0] - vals_b[0]) + FMath::Square(vals_a[1] - vals_b[1]) <= key_tolerance_sq)
+                && (FMath::Square(vals_a[2] - vals_b[2]) + FMath::Square(vals_a[3] - vals_b[3]) <= key_tolerance_sq);
+        };
+        
+        // Every key in between has to stay close to the line between the ends of the span
+        auto spanWithinError = [&](int32 start_key, int32 end_key)
+        {
+            const float * start_vals = readKey(start_key);
+            const float * end_vals = readKey(end_key);
+            const float span_length = (float)(key_frames[end_key] - key_frames[start_key]);
+            for(auto k = start_key + 1; k < end_key; k++) {
+                const float ratio = (float)(key_frames[k] - key_frames[start_key]) / span_length;
+                float interp_vals[4];
+                for(auto j = 0; j < 4; j++) {
+                    interp_vals[j] = start_vals[j] + ratio * (end_vals[j] - start_vals[j]);
+                }
+                
+                if(pointsWithinError(interp_vals, readKey(k)) == false) {
+                    return false;
+                }
+            }
+            
+            return true;
+        };
+        
+        kept_keys.Reset();
+        kept_keys.Add(0);
+        
+        bool is_constant = true;
+        for(auto k = 1; (k < num_keys) && is_constant; k++) {
+            is_constant = pointsWithinError(readKey(0), readKey(k));
+        }
+        
+        if(is_constant == false) {
+            // Extend each span as long as the dropped keys allow it
+            int32 span_start = 0;
+            for(auto k = 2; k < num_keys; k++) {
+                if(spanWithinError(span_start, k) == false) {
+                    span_start = k - 1;
+                    kept_keys.Add(span_start);
+                }
+            }
+            
+            kept_keys.Add(num_keys - 1);
+        }
+        
+        cur_track.first_key = new_frames.Num();
+        cur_track.num_keys = kept_keys.Num();
+        for(auto cur_key : kept_keys) {
+            new_frames.Add((uint16)key_frames[cur_key]);
+            
+            const float * cur_vals = readKey(cur_key);
+            for(auto j = 0; j < 4; j++) {
+                int32 quantized_val = 0;
+                if(cur_track.bounds_step[j] > 0) {
+                    quantized_val = FMath::RoundToInt((cur_vals[j] - cur_track.bounds_min[j]) / cur_track.bounds_step[j]);
+                }
+                
+                new_values.Add((uint16)clipNumber(quantized_val, 0, (int32)MAX_uint16));
+            }
+        }
+    }
+    
+    compressed_tracks = MoveTemp(new_tracks);
+    compressed_frames = MoveTemp(new_frames);
+    compressed_values = MoveTemp(new_values);
+    
+    // The raw rows are not needed anymore
+    flat_cache.Empty();
+    
+    return true;
+}
+
+void
+meshBoneCacheManager::setCompressedTracks(const TArray<FName>& bone_keys_in,
+                                          const TArray<meshBoneCompressedTrack>& tracks_in,
+                                          const TArray<uint16>& frames_in,
+                                          const TArray<uint16>& values_in)
+{
+    makeAllReady();
+    
+    setFlatBoneKeys(bone_keys_in);
+    
+    compressed_tracks = tracks_in;
+    compressed_frames = frames_in;
+    compressed_values = values_in;
+}
+
+bool
+meshBoneCacheManager::isCompressed() const
+{
+    return compressed_tracks.Num() > 0;
+}
+
+const TArray<meshBoneCompressedTrack>&
+meshBoneCacheManager::getCompressedTracks() const
+{
+    return compressed_tracks;
+}
+
+const TArray<uint16>&
+meshBoneCacheManager::getCompressedFrames() const
+{
+    return compressed_frames;
+}
+
+const TArray<uint16>&
+meshBoneCacheManager::getCompressedValues() const
+{
+    return compressed_values;
+}
+
+float
+meshBoneCacheManager::getCompressedTime(float time_in) const
+{
+    return clipNumber(time_in - (float)start_time, 0.0f, (float)(end_time - start_time));
+}
+
+void
+meshBoneCacheManager::decodeCompressedBone(int32 bone_index, float local_time, float * vals_out) const
+{
+    const meshBoneCompressedTrack& cur_track = compressed_tracks[bone_index];
+    const uint16 * track_frames = compressed_frames.GetData() + cur_track.first_key;
+    const uint16 * track_values = compressed_values.GetData() + (cur_track.first_key * 4);
+    
+    // Last kept key at or before the time
+    int32 base_key = 0;
+    int32 high_key = cur_track.num_keys - 1;
+    while(base_key < high_key) {
+        const int32 mid_key = (base_key + high_key + 1) / 2;
+        if((float)track_frames[mid_key] <= local_time) {
+            base_key = mid_key;
+        }
+        else {
+            high_key = mid_key - 1;
+        }
+    }
+    
+    const uint16 * base_vals = track_values + (base_key * 4);
+    const uint16 * end_vals = base_vals;
+    float ratio = 0;
+    if(base_key + 1 < cur_track.num_keys) {
+        end_vals = base_vals + 4;
+        ratio = FMath::Max((local_time - (float)track_frames[base_key])
+                           / (float)(track_frames[base_key + 1] - track_frames[base_key]), 0.0f);
+    }
+    
+    for(auto j = 0; j < 4; j++) {
+        const float quantized_val = (float)base_vals[j] + ratio * ((float)end_vals[j] - (float)base_vals[j]);
+        vals_out[j] = cur_track.bounds_min[j] + (quantized_val * cur_track.bounds_step[j]);
+    }
+}
+
 int32 meshBoneCacheManager::getStartTime() const
 {
     return start_time;
@@ -1439,7 +2519,7 @@ int32
 meshBoneCacheManager::getIndexByTime(int32 time_in) const
 {
     int32 retval = time_in - start_time;
-    retval = clipNumber(retval, 0, (int32)bone_cache_table.Num() - 1);
+    retval = clipNumber(retval, 0, (int32)bone_cache_data_ready.Num() - 1);
 
     return retval;
 }
@@ -1448,6 +2528,11 @@ void
 meshBoneCacheManager::setValuesAtTime(int32 time_in,
                                       TMap<FName, meshBone *>& bone_map)
 {
+    if(frame_keys.Num() > 0) {
+        // keys are already compacted
+        return;
+    }
+    
     TArray<meshBoneCache> cache_list;
     int32 set_index = getIndexByTime(time_in);
     for(auto& cur_iter : bone_map)
@@ -1494,18 +2579,42 @@ meshBoneCacheManager::retrieveValuesAtTime(float time_in,
 {
 	SCOPE_CYCLE_COUNTER(STAT_MeshBoneCacheManager_retrieveValuesAtTime);
 
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-
-    float ratio = (time_in - (float)floorf(time_in));
+    if(compressed_tracks.Num() > 0) {
+        const float local_time = getCompressedTime(time_in);
+        for(auto i = 0; i < flat_bone_keys.Num(); i++) {
+            float cur_vals[4];
+            decodeCompressedBone(i, local_time, cur_vals);
+            
+            meshBone * cur_bone = bone_map[flat_bone_keys[i]];
+            cur_bone->setWorldStartPt(glm::vec4(cur_vals[0], cur_vals[1], 0, 1.0f));
+            cur_bone->setWorldEndPt(glm::vec4(cur_vals[2], cur_vals[3], 0, 1.0f));
+        }
+        
+        return;
+    }
 
-    if(bone_cache_data_ready.Num() == 0) {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
-    if((bone_cache_data_ready[base_time] == false)
-       || (bone_cache_data_ready[final_time] == false))
-    {
+    if(flat_cache.Num() > 0) {
+        const int32 row_size = flat_bone_keys.Num() * 4;
+        const float * base_row = flat_cache.GetData() + (base_time * row_size);
+        const float * end_row = flat_cache.GetData() + (final_time * row_size);
+        for(auto i = 0; i < flat_bone_keys.Num(); i++) {
+            meshBone * cur_bone = bone_map[flat_bone_keys[i]];
+            const float * base_vals = base_row + (i * 4);
+            const float * end_vals = end_row + (i * 4);
+            cur_bone->setWorldStartPt(glm::vec4(base_vals[0] + ratio * (end_vals[0] - base_vals[0]),
+                                                base_vals[1] + ratio * (end_vals[1] - base_vals[1]),
+                                                0, 1.0f));
+            cur_bone->setWorldEndPt(glm::vec4(base_vals[2] + ratio * (end_vals[2] - base_vals[2]),
+                                              base_vals[3] + ratio * (end_vals[3] - base_vals[3]),
+                                              0, 1.0f));
+        }
+        
         return;
     }
     
@@ -1528,22 +2637,107 @@ meshBoneCacheManager::retrieveValuesAtTime(float time_in,
     }    
 }
 
+void
+meshBoneCacheManager::retrieveValuesAtTime(float time_in,
+                                           meshRenderBoneComposition& composition)
+{
+    if(((flat_cache.Num() == 0) && (compressed_tracks.Num() == 0))
+       || (composition.getBoneSlotLayout().IsValid() == false))
+    {
+        retrieveValuesAtTime(time_in, composition.getBonesMap());
+        return;
+    }
+    
+	SCOPE_CYCLE_COUNTER(STAT_MeshBoneCacheManager_retrieveValuesAtTime);
+    
+    const TArray<int32>& flat_bone_slots = composition.getCacheBoneSlots(*this);
+    TArray<meshBone *>& bone_slots = composition.getBoneSlots();
+    if(compressed_tracks.Num() > 0) {
+        const float local_time = getCompressedTime(time_in);
+        for(auto i = 0; i < flat_bone_slots.Num(); i++) {
+            const int32 cur_slot = flat_bone_slots[i];
+            if(cur_slot < 0) {
+                continue;
+            }
+            
+            float final_vals[4];
+            decodeCompressedBone(i, local_time, final_vals);
+            
+            meshBone * cur_bone = bone_slots[cur_slot];
+            cur_bone->setWorldStartPt(glm::vec4(final_vals[0], final_vals[1], 0, 1.0f));
+            cur_bone->setWorldEndPt(glm::vec4(final_vals[2], final_vals[3], 0, 1.0f));
+        }
+        
+        return;
+    }
+    
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
+        return;
+    }
+    
+    // Lerp two contiguous key rows straight into the bone slots
+    const int32 row_size = flat_bone_slots.Num() * 4;
+    const float * base_row = flat_cache.GetData() + (base_time * row_size);
+    const float * end_row = flat_cache.GetData() + (final_time * row_size);
+    
+    for(auto i = 0; i < flat_bone_slots.Num(); i++) {
+        const int32 cur_slot = flat_bone_slots[i];
+        if(cur_slot < 0) {
+            continue;
+        }
+        
+        const float * base_vals = base_row + (i * 4);
+        const float * end_vals = end_row + (i * 4);
+        float final_vals[4];
+        for(auto j = 0; j < 4; j++) {
+            final_vals[j] = base_vals[j] + ratio * (end_vals[j] - base_vals[j]);
+        }
+        
+        meshBone * cur_bone = bone_slots[cur_slot];
+        cur_bone->setWorldStartPt(glm::vec4(final_vals[0], final_vals[1], 0, 1.0f));
+        cur_bone->setWorldEndPt(glm::vec4(final_vals[2], final_vals[3], 0, 1.0f));
+    }
+}
+
 std::pair<glm::vec4, glm::vec4>
 meshBoneCacheManager::retrieveSingleBoneValueAtTime(const FName& key_in,
 	float time_in)
 {
-	int32 base_time = getIndexByTime((int32)floorf(time_in));
-	int32 final_time = getIndexByTime((int32)ceilf(time_in));
-	float ratio = (time_in - (float)floorf(time_in));
+	int32 base_time, final_time;
+	float ratio;
 	std::pair<glm::vec4, glm::vec4> ret_data;
 
-	if (bone_cache_data_ready.Num() == 0) {
+	if (compressed_tracks.Num() > 0) {
+		int32 bone_index = flat_bone_keys.Find(key_in);
+		if (bone_index != INDEX_NONE) {
+			float cur_vals[4];
+			decodeCompressedBone(bone_index, getCompressedTime(time_in), cur_vals);
+			ret_data.first = glm::vec4(cur_vals[0], cur_vals[1], 0, 1.0f);
+			ret_data.second = glm::vec4(cur_vals[2], cur_vals[3], 0, 1.0f);
+		}
+
 		return ret_data;
 	}
 
-	if ((bone_cache_data_ready[base_time] == false)
-		|| (bone_cache_data_ready[final_time] == false))
-	{
+	if (getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
+		return ret_data;
+	}
+
+	if (flat_cache.Num() > 0) {
+		int32 bone_index = flat_bone_keys.Find(key_in);
+		if (bone_index != INDEX_NONE) {
+			const int32 row_size = flat_bone_keys.Num() * 4;
+			const float * base_vals = flat_cache.GetData() + (base_time * row_size) + (bone_index * 4);
+			const float * end_vals = flat_cache.GetData() + (final_time * row_size) + (bone_index * 4);
+
+			ret_data.first = ((1.0f - ratio) * glm::vec4(base_vals[0], base_vals[1], 0, 1.0f)) +
+				(ratio * glm::vec4(end_vals[0], end_vals[1], 0, 1.0f));
+			ret_data.second = ((1.0f - ratio) * glm::vec4(base_vals[2], base_vals[3], 0, 1.0f)) +
+				(ratio * glm::vec4(end_vals[2], end_vals[3], 0, 1.0f));
+		}
+
 		return ret_data;
 	}
 
@@ -1600,7 +2794,13 @@ void meshDisplacementCacheManager::init(int32 start_time_in, int32 end_time_in)
     }
     
     is_ready = false;
-
+    
+    key_frames.Empty();
+    frame_keys.Empty();
+    
+    basis_tracks.Empty();
+    basis_values.Empty();
+    basis_coeffs.Empty();
 }
 
 void
@@ -1609,6 +2809,10 @@ meshDisplacementCacheManager::makeAllReady()
     for(auto i = 0; i < displacement_cache_data_ready.Num(); i++) {
         displacement_cache_data_ready[i] = true;
     }
+    
+    if(frame_keys.Num() == 0) {
+        compactCacheKeys(displacement_cache_table, key_frames, frame_keys);
+    }
 }
 
 TArray<TArray<meshDisplacementCache> >&
@@ -1617,6 +2821,356 @@ meshDisplacementCacheManager::getCacheTable()
     return displacement_cache_table;
 }
 
+bool
+meshDisplacementCacheManager::getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const
+{
+    return findCacheKeys(key_frames, frame_keys, time_in - (float)start_time, base_key, end_key, ratio);
+}
+
+const TArray<int32>&
+meshDisplacementCacheManager::getKeyFrames() const
+{
+    return key_frames;
+}
+
+void
+meshDisplacementCacheManager::getDisplacementUsage(int32 region_index, bool& use_local_out, bool& use_post_out) const
+{
+    if(basis_tracks.Num() > 0) {
+        use_local_out = (basis_tracks[region_index].num_local_pts > 0);
+        use_post_out = (basis_tracks[region_index].num_post_pts > 0);
+        return;
+    }
+    
+    const meshDisplacementCache& first_cache = displacement_cache_table[0][region_index];
+    use_local_out = (first_cache.getLocalDisplacements().Num() > 0);
+    use_post_out = (first_cache.getPostDisplacements().Num() > 0);
+}
+
+// Largest eigenvalue of a symmetric positive semi definite matrix and its unit eigenvector, by power iteration
+static double findTopEigenVector(const TArray<double>& matrix_in, int32 size_in, TArray<double>& vec_out)
+{
+    // Start from the row with the most energy
+    int32 start_idx = 0;
+    for(auto i = 1; i < size_in; i++) {
+        if(matrix_in[(i * size_in) + i] > matrix_in[(start_idx * size_in) + start_idx]) {
+            start_idx = i;
+        }
+    }
+    
+    vec_out.Reset();
+    vec_out.SetNumZeroed(size_in);
+    vec_out[start_idx] = 1.0;
+    
+    TArray<double> next_vec;
+    next_vec.SetNumUninitialized(size_in);
+    double eigen_value = 0;
+    for(auto iter = 0; iter < 256; iter++) {
+        double next_length = 0;
+        for(auto i = 0; i < size_in; i++) {
+            const double * cur_row = matrix_in.GetData() + (i * size_in);
+            double cur_val = 0;
+            for(auto j = 0; j < size_in; j++) {
+                cur_val += cur_row[j] * vec_out[j];
+            }
+            
+            next_vec[i] = cur_val;
+            next_length += cur_val * cur_val;
+        }
+        
+        next_length = sqrt(next_length);
+        if(next_length <= 0) {
+            return 0;
+        }
+        
+        double change = 0;
+        for(auto i = 0; i < size_in; i++) {
+            next_vec[i] /= next_length;
+            change += (next_vec[i] - vec_out[i]) * (next_vec[i] - vec_out[i]);
+        }
+        
+        Swap(vec_out, next_vec);
+        eigen_value = next_length;
+        if(change < 1e-14) {
+            break;
+        }
+    }
+    
+    return eigen_value;
+}
+
+bool
+meshDisplacementCacheManager::compressTracks(float tolerance_in)
+{
+    if((tolerance_in <= 0) || (displacement_cache_table.Num() == 0) || (basis_tracks.Num() > 0)) {
+        return false;
+    }
+    
+    // Every key has to list the same regions with the same number of points
+    const TArray<meshDisplacementCache>& first_key = displacement_cache_table[0];
+    for(auto& cur_row : displacement_cache_table) {
+        if(cur_row.Num() != first_key.Num()) {
+            return false;
+        }
+        
+        for(auto j = 0; j < cur_row.Num(); j++) {
+            if((cur_row[j].getKey() != first_key[j].getKey())
+               || (cur_row[j].getLocalDisplacements().Num() != first_key[j].getLocalDisplacements().Num())
+               || (cur_row[j].getPostDisplacements().Num() != first_key[j].getPostDisplacements().Num()))
+            {
+                return false;
+            }
+        }
+    }
+    
+    const int32 num_keys = displacement_cache_table.Num();
+    const float tolerance_sq = tolerance_in * tolerance_in;
+    
+    TArray<meshDisplacementBasisTrack> new_tracks;
+    TArray<float> new_values;
+    TArray<float> new_coeffs;
+    new_tracks.SetNumZeroed(first_key.Num());
+    
+    TArray<float> centered_vals, residual_vals, cur_shape;
+    TArray<double> gram, eigen_vec;
+    TArray<TArray<float> > basis_weights;
+    for(auto r = 0; r < first_key.Num(); r++) {
+        meshDisplacementBasisTrack& cur_track = new_tracks[r];
+        cur_track.key = first_key[r].getKey();
+        cur_track.num_local_pts = first_key[r].getLocalDisplacements().Num();
+        cur_track.num_post_pts = first_key[r].getPostDisplacements().Num();
+        cur_track.basis_offset = new_values.Num();
+        cur_track.coeffs_offset = new_coeffs.Num();
+        
+        // One row of local then post displacements per key
+        const int32 num_local_vals = cur_track.num_local_pts * 2;
+        const int32 num_vals = num_local_vals + (cur_track.num_post_pts * 2);
+        centered_vals.SetNumUninitialized(num_keys * num_vals);
+        for(auto k = 0; k < num_keys; k++) {
+            const meshDisplacementCache& cur_cache = displacement_cache_table[k][r];
+            float * write_vals = centered_vals.GetData() + (k * num_vals);
+            FMemory::Memcpy(write_vals, cur_cache.getLocalDisplacements().GetData(), sizeof(float) * num_local_vals);
+            FMemory::Memcpy(write_vals + num_local_vals, cur_cache.getPostDisplacements().GetData(), sizeof(float) * (num_vals - num_local_vals));
+        }
+        
+        // Mean shape first, the basis shapes model what is left
+        const int32 mean_offset = new_values.AddZeroed(num_vals);
+        for(auto j = 0; j < num_vals; j++) {
+            double cur_sum = 0;
+            for(auto k = 0; k < num_keys; k++) {
+                cur_sum += centered_vals[(k * num_vals) + j];
+            }
+            
+            new_values[mean_offset + j] = (float)(cur_sum / num_keys);
+        }
+        
+        for(auto k = 0; k < num_keys; k++) {
+            float * cur_vals = centered_vals.GetData() + (k * num_vals);
+            for(auto j = 0; j < num_vals; j++) {
+                cur_vals[j] -= new_values[mean_offset + j];
+            }
+        }
+        
+        // Eigenvectors of the gram matrix of the keys give the principal shapes
+        gram.SetNumUninitialized(num_keys * num_keys);
+        for(auto a = 0; a < num_keys; a++) {
+            const float * vals_a = centered_vals.GetData() + (a * num_vals);
+            for(auto b = a; b < num_keys; b++) {
+                const float * vals_b = centered_vals.GetData() + (b * num_vals);
+                double cur_dot = 0;
+                for(auto j = 0; j < num_vals; j++) {
+                    cur_dot += (double)vals_a[j] * (double)vals_b[j];
+                }
+                
+                gram[(a * num_keys) + b] = gram[(b * num_keys) + a] = cur_dot;
+            }
+        }
+        
+        auto residualWithinError = [&]()
+        {
+            for(auto i = 0; i < residual_vals.Num(); i += 2) {
+                if(FMath::Square(residual_vals[i]) + FMath::Square(residual_vals[i + 1]) > tolerance_sq) {
+                    return false;
+                }
+            }
+            
+            return true;
+        };
+        
+        // Add the strongest shape until every key is reconstructed within tolerance
+        residual_vals = centered_vals;
+        basis_weights.Reset();
+        while((basis_weights.Num() < num_keys) && (residualWithinError() == false)) {
+            const double eigen_value = findTopEigenVector(gram, num_keys, eigen_vec);
+            if(eigen_value <= SMALL_NUMBER) {
+                break;
+            }
+            
+            const double eigen_scale = sqrt(eigen_value);
+            cur_shape.SetNumZeroed(num_vals);
+            for(auto k = 0; k < num_keys; k++) {
+                const float * cur_vals = centered_vals.GetData() + (k * num_vals);
+                const float cur_weight = (float)(eigen_vec[k] / eigen_scale);
+                for(auto j = 0; j < num_vals; j++) {
+                    cur_shape[j] += cur_weight * cur_vals[j];
+                }
+            }
+            
+            TArray<float>& cur_weights = basis_weights[basis_weights.AddDefaulted()];
+            cur_weights.SetNumUninitialized(num_keys);
+            for(auto k = 0; k < num_keys; k++) {
+                cur_weights[k] = (float)(eigen_vec[k] * eigen_scale);
+                float * cur_residual = residual_vals.GetData() + (k * num_vals);
+                for(auto j = 0; j < num_vals; j++) {
+                    cur_residual[j] -= cur_weights[k] * cur_shape[j];
+                }
+            }
+            
+            new_values.Append(cur_shape);
+            
+            // Deflate so the next pass finds the next strongest shape
+            for(auto a = 0; a < num_keys; a++) {
+                for(auto b = 0; b < num_keys; b++) {
+                    gram[(a * num_keys) + b] -= eigen_value * eigen_vec[a] * eigen_vec[b];
+                }
+            }
+        }
+        
+        cur_track.num_basis = basis_weights.Num();
+        for(auto k = 0; k < num_keys; k++) {
+            for(auto& cur_weights : basis_weights) {
+                new_coeffs.Add(cur_weights[k]);
+            }
+        }
+    }
+    
+    basis_tracks = MoveTemp(new_tracks);
+    basis_values = MoveTemp(new_values);
+    basis_coeffs = MoveTemp(new_coeffs);
+    
+    // The raw keys are not needed anymore
+    displacement_cache_table.Empty();
+    
+    return true;
+}
+
+void
+meshDisplacementCacheManager::setBasisTracks(const TArray<int32>& key_frames_in,
+                                             const TArray<meshDisplacementBasisTrack>& tracks_in,
+                                             const TArray<float>& values_in,
+                                             const TArray<float>& coeffs_in)
+{
+    makeAllReady();
+    
+    key_frames = key_frames_in;
+    int32 cur_key = -1;
+    for(auto i = 0; i < frame_keys.Num(); i++) {
+        while((cur_key + 1 < key_frames.Num()) && (key_frames[cur_key + 1] <= i)) {
+            cur_key++;
+        }
+        
+        frame_keys[i] = cur_key;
+    }
+    
+    basis_tracks = tracks_in;
+    basis_values = values_in;
+    basis_coeffs = coeffs_in;
+}
+
+bool
+meshDisplacementCacheManager::isCompressed() const
+{
+    return basis_tracks.Num() > 0;
+}
+
+const TArray<meshDisplacementBasisTrack>&
+meshDisplacementCacheManager::getBasisTracks() const
+{
+    return basis_tracks;
+}
+
+const TArray<float>&
+meshDisplacementCacheManager::getBasisValues() const
+{
+    return basis_values;
+}
+
+const TArray<float>&
+meshDisplacementCacheManager::getBasisCoeffs() const
+{
+    return basis_coeffs;
+}
+
+int32
+meshDisplacementCacheManager::findBasisTrack(const FName& key_in) const
+{
+    for(auto i = 0; i < basis_tracks.Num(); i++) {
+        if(basis_tracks[i].key == key_in) {
+            return i;
+        }
+    }
+    
+    return INDEX_NONE;
+}
+
+void
+meshDisplacementCacheManager::decodeBasisTrack(const meshDisplacementBasisTrack& track_in,
+                                               int32 base_key,
+                                               int32 end_key,
+                                               float ratio,
+                                               float * local_out,
+                                               float * post_out) const
+{
+    // Blending the coefficients gives the same result as blending the reconstructed keys
+    const float * base_coeffs = basis_coeffs.GetData() + track_in.coeffs_offset + (base_key * track_in.num_basis);
+    const float * end_coeffs = basis_coeffs.GetData() + track_in.coeffs_offset + (end_key * track_in.num_basis);
+    TArray<float, TInlineAllocator<32> > cur_coeffs;
+    TArray<VectorRegister, TInlineAllocator<32> > coeff_vecs;
+    cur_coeffs.SetNumUninitialized(track_in.num_basis);
+    coeff_vecs.SetNumUninitialized(track_in.num_basis);
+    for(auto i = 0; i < track_in.num_basis; i++) {
+        cur_coeffs[i] = base_coeffs[i] + ratio * (end_coeffs[i] - base_coeffs[i]);
+        coeff_vecs[i] = VectorSetFloat1(cur_coeffs[i]);
+    }
+    
+    const int32 num_local_vals = track_in.num_local_pts * 2;
+    const int32 num_vals = num_local_vals + (track_in.num_post_pts * 2);
+    const float * mean_vals = basis_values.GetData() + track_in.basis_offset;
+    
+    // mean + shapes * coefficients, 4 values at a time
+    auto decodeRange = [&](int32 first_val, int32 range_vals, float * vals_out)
+    {
+        const int32 num_blocks = range_vals / 4;
+        for(auto b = 0; b < num_blocks; b++) {
+            const int32 cur_idx = first_val + (b * 4);
+            VectorRegister accum = VectorLoad(mean_vals + cur_idx);
+            for(auto i = 0; i < track_in.num_basis; i++) {
+                accum = VectorMultiplyAdd(coeff_vecs[i], VectorLoad(mean_vals + ((i + 1) * num_vals) + cur_idx), accum);
+            }
+            
+            VectorStore(accum, vals_out + (b * 4));
+        }
+        
+        // Leftover values
+        for(auto j = num_blocks * 4; j < range_vals; j++) {
+            float cur_val = mean_vals[first_val + j];
+            for(auto i = 0; i < track_in.num_basis; i++) {
+                cur_val += cur_coeffs[i] * mean_vals[((i + 1) * num_vals) + first_val + j];
+            }
+            
+            vals_out[j] = cur_val;
+        }
+    };
+    
+    if(local_out) {
+        decodeRange(0, num_local_vals, local_out);
+    }
+    
+    if(post_out) {
+        decodeRange(num_local_vals, num_vals - num_local_vals, post_out);
+    }
+}
+
 int32 meshDisplacementCacheManager::getStartTime() const
 {
     return start_time;
@@ -1630,7 +3184,7 @@ int32 meshDisplacementCacheManager::getEndime() const
 int32 meshDisplacementCacheManager::getIndexByTime(int32 time_in) const
 {
     int32 retval = time_in - start_time;
-    retval = clipNumber(retval, 0, (int32)displacement_cache_table.Num() - 1);
+    retval = clipNumber(retval, 0, (int32)displacement_cache_data_ready.Num() - 1);
 
     return retval;
 }
@@ -1638,6 +3192,11 @@ int32 meshDisplacementCacheManager::getIndexByTime(int32 time_in) const
 void meshDisplacementCacheManager::setValuesAtTime(int32 time_in,
                                                    TMap<FName,meshRenderRegion *>& regions_map)
 {
+    if(frame_keys.Num() > 0) {
+        // keys are already compacted
+        return;
+    }
+    
     TArray<meshDisplacementCache> cache_list;
     int32 set_index = getIndexByTime(time_in);
     for(auto& cur_iter : regions_map)
@@ -1664,18 +3223,45 @@ void meshDisplacementCacheManager::setValuesAtTime(int32 time_in,
 void meshDisplacementCacheManager::retrieveValuesAtTime(float time_in,
                                                         TMap<FName,meshRenderRegion *>& regions_map)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    
-    float ratio = (time_in - (float)floorf(time_in));
-    
-    if(displacement_cache_data_ready.Num() == 0) {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
-    if((displacement_cache_data_ready[base_time] == false)
-       || (displacement_cache_data_ready[final_time] == false))
-    {
+    if(basis_tracks.Num() > 0) {
+        for(auto& cur_track : basis_tracks) {
+            meshRenderRegion * set_region = regions_map[cur_track.key];
+            float * local_out = NULL;
+            float * post_out = NULL;
+            
+            if(set_region->getUseLocalDisplacements()) {
+                TArray<glm::vec2>& displacements = set_region->getLocalDisplacements();
+                if(cur_track.num_local_pts == displacements.Num()) {
+                    local_out = (float *)displacements.GetData();
+                }
+                else {
+                    for(auto j = 0; j < displacements.Num(); j++) {
+                        displacements[j] = glm::vec2(0, 0);
+                    }
+                }
+            }
+            
+            if(set_region->getUsePostDisplacements()) {
+                TArray<glm::vec2>& displacements = set_region->getPostDisplacements();
+                if(cur_track.num_post_pts == displacements.Num()) {
+                    post_out = (float *)displacements.GetData();
+                }
+                else {
+                    for(auto j = 0; j < displacements.Num(); j++) {
+                        displacements[j] = glm::vec2(0, 0);
+                    }
+                }
+            }
+            
+            decodeBasisTrack(cur_track, base_time, final_time, ratio, local_out, post_out);
+        }
+        
         return;
     }
         
@@ -1737,18 +3323,23 @@ meshDisplacementCacheManager::retrieveSingleDisplacementValueAtTime(const FName&
                                                                    float time_in,
                                                                     meshRenderRegion * region)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    float ratio = (time_in - (float)floorf(time_in));
-    std::pair<glm::vec4, glm::vec4> ret_data;
-    
-    if(displacement_cache_data_ready.Num() == 0) {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
-    if((displacement_cache_data_ready[base_time] == false)
-       || (displacement_cache_data_ready[final_time] == false))
-    {
+    if(basis_tracks.Num() > 0) {
+        const int32 track_idx = findBasisTrack(key_in);
+        if(track_idx != INDEX_NONE) {
+            decodeBasisTrack(basis_tracks[track_idx],
+                             base_time,
+                             final_time,
+                             ratio,
+                             region->getUseLocalDisplacements() ? (float *)region->getLocalDisplacements().GetData() : NULL,
+                             region->getUsePostDisplacements() ? (float *)region->getPostDisplacements().GetData() : NULL);
+        }
+        
         return;
     }
         
@@ -1795,18 +3386,25 @@ meshDisplacementCacheManager::retrieveSingleDisplacementValueNoRegionAtTime(cons
                                                                             meshRenderRegion * region,
                                                                             TArray<glm::vec2>& out_displacements)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    float ratio = (time_in - (float)floorf(time_in));
-    std::pair<glm::vec4, glm::vec4> ret_data;
-    
-    if(displacement_cache_data_ready.Num() == 0) {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
-    if((displacement_cache_data_ready[base_time] == false)
-       || (displacement_cache_data_ready[final_time] == false))
-    {
+    if(basis_tracks.Num() > 0) {
+        const int32 track_idx = findBasisTrack(key_in);
+        if(track_idx != INDEX_NONE) {
+            // same as below, post displacements win when the region uses both
+            if(region->getUseLocalDisplacements()) {
+                decodeBasisTrack(basis_tracks[track_idx], base_time, final_time, ratio, (float *)out_displacements.GetData(), NULL);
+            }
+            
+            if(region->getUsePostDisplacements()) {
+                decodeBasisTrack(basis_tracks[track_idx], base_time, final_time, ratio, NULL, (float *)out_displacements.GetData());
+            }
+        }
+        
         return;
     }
         
@@ -1853,18 +3451,32 @@ meshDisplacementCacheManager::retrieveSingleDisplacementValueDirectAtTime(const
                                                                           TArray<glm::vec2>& out_local_displacements,
                                                                           TArray<glm::vec2>& out_post_displacements)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    float ratio = (time_in - (float)floorf(time_in));
-    std::pair<glm::vec4, glm::vec4> ret_data;
-    
-    if(displacement_cache_data_ready.Num() == 0) {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
-    if((displacement_cache_data_ready[base_time] == false)
-       || (displacement_cache_data_ready[final_time] == false))
-    {
+    if(basis_tracks.Num() > 0) {
+        const int32 track_idx = findBasisTrack(key_in);
+        if(track_idx != INDEX_NONE) {
+            const meshDisplacementBasisTrack& cur_track = basis_tracks[track_idx];
+            float * local_out = NULL;
+            float * post_out = NULL;
+            
+            if(cur_track.num_local_pts > 0) {
+                out_local_displacements.SetNumZeroed(cur_track.num_local_pts);
+                local_out = (float *)out_local_displacements.GetData();
+            }
+            
+            if(cur_track.num_post_pts > 0) {
+                out_post_displacements.SetNumZeroed(cur_track.num_post_pts);
+                post_out = (float *)out_post_displacements.GetData();
+            }
+            
+            decodeBasisTrack(cur_track, base_time, final_time, ratio, local_out, post_out);
+        }
+        
         return;
     }
         
@@ -1957,6 +3569,9 @@ meshUVWarpCacheManager::init(int32 start_time_in, int32 end_time_in)
     }
     
     is_ready = false;
+    
+    key_frames.Empty();
+    frame_keys.Empty();
 }
 
 void
@@ -1965,6 +3580,10 @@ meshUVWarpCacheManager::makeAllReady()
     for(auto i = 0; i < uv_cache_data_ready.Num(); i++) {
         uv_cache_data_ready[i] = true;
     }
+    
+    if(frame_keys.Num() == 0) {
+        compactCacheKeys(uv_cache_table, key_frames, frame_keys);
+    }
 }
 
 int32
@@ -1985,11 +3604,23 @@ meshUVWarpCacheManager::getCacheTable()
     return uv_cache_table;
 }
 
+bool
+meshUVWarpCacheManager::getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const
+{
+    return findCacheKeys(key_frames, frame_keys, time_in - (float)start_time, base_key, end_key, ratio);
+}
+
+const TArray<int32>&
+meshUVWarpCacheManager::getKeyFrames() const
+{
+    return key_frames;
+}
+
 int32
 meshUVWarpCacheManager::getIndexByTime(int32 time_in) const
 {
     int32 retval = time_in - start_time;
-    retval = clipNumber(retval, 0, (int32)uv_cache_table.Num() - 1);
+    retval = clipNumber(retval, 0, (int32)uv_cache_data_ready.Num() - 1);
 
     return retval;
 }
@@ -1998,6 +3629,11 @@ void
 meshUVWarpCacheManager::setValuesAtTime(int32 time_in,
                                         TMap<FName, meshRenderRegion *>& regions_map)
 {
+    if(frame_keys.Num() > 0) {
+        // keys are already compacted
+        return;
+    }
+    
     int32 set_index = getIndexByTime(time_in);
     TArray<meshUVWarpCache> cache_list;
     for(auto& cur_iter : regions_map) {
@@ -2024,16 +3660,10 @@ void
 meshUVWarpCacheManager::retrieveValuesAtTime(float time_in,
                                             TMap<FName, meshRenderRegion *>& regions_map)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    
-    if(uv_cache_data_ready.Num() == 0) {
-        return;
-    }
-    
-    if((uv_cache_data_ready[base_time] == false)
-       || (uv_cache_data_ready[final_time] == false))
-    {
+    // uv warps are not blended, the last key holds until the next one
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
         
@@ -2068,21 +3698,13 @@ meshUVWarpCacheManager::retrieveSingleValueAtTime(float time_in,
                                                   glm::vec2& global_offset,
                                                   glm::vec2& scale)
 {
-    int32 base_time = getIndexByTime((int32)floorf(time_in));
-    int32 final_time = getIndexByTime((int32)ceilf(time_in));
-    
-    if(uv_cache_data_ready.Num() == 0) {
-        return;
-    }
-    
-    if((uv_cache_data_ready[base_time] == false)
-       || (uv_cache_data_ready[final_time] == false))
-    {
+    int32 base_time, final_time;
+    float ratio;
+    if(getKeysAtTime(time_in, base_time, final_time, ratio) == false) {
         return;
     }
     
     TArray<meshUVWarpCache>& base_cache = uv_cache_table[base_time];
-    TArray<meshUVWarpCache>& end_cache = uv_cache_table[final_time];
     
     local_offset = glm::vec2(0,0);
     global_offset = glm::vec2(0,0);
@@ -2090,7 +3712,6 @@ meshUVWarpCacheManager::retrieveSingleValueAtTime(float time_in,
     
     for(auto i = 0; i < base_cache.Num(); i++) {
         const meshUVWarpCache& base_data = base_cache[i];
-        const meshUVWarpCache& end_data = end_cache[i];
         const FName &cur_key = base_data.getKey();
         
         meshRenderRegion * set_region = region;
@@ -2159,6 +3780,9 @@ meshOpacityCacheManager::init(int32 start_time_in, int32 end_time_in)
 	}
 
 	is_ready = false;
+
+	key_frames.Empty();
+	frame_keys.Empty();
 }
 
 void
@@ -2167,6 +3791,10 @@ meshOpacityCacheManager::makeAllReady()
 	for (auto i = 0; i < opacity_cache_data_ready.Num(); i++) {
 		opacity_cache_data_ready[i] = true;
 	}
+
+	if (frame_keys.Num() == 0) {
+		compactCacheKeys(opacity_cache_table, key_frames, frame_keys);
+	}
 }
 
 int32
@@ -2187,11 +3815,97 @@ meshOpacityCacheManager::getCacheTable()
 	return opacity_cache_table;
 }
 
+bool
+meshOpacityCacheManager::getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const
+{
+	return findCacheKeys(key_frames, frame_keys, time_in - (float)start_time, base_key, end_key, ratio);
+}
+
+const TArray<int32>&
+meshOpacityCacheManager::getKeyFrames() const
+{
+	return key_frames;
+}
+
+void
+meshOpacityCacheManager::insertKeys(const TArray<int32>& frames_in)
+{
+	if (key_frames.Num() == 0) {
+		return;
+	}
+
+	TArray<int32> new_frames;
+	for (auto cur_frame : frames_in) {
+		if (frame_keys.IsValidIndex(cur_frame) && (key_frames.Contains(cur_frame) == false)) {
+			new_frames.AddUnique(cur_frame);
+		}
+	}
+
+	if (new_frames.Num() == 0) {
+		return;
+	}
+
+	new_frames.Sort();
+
+	// Merge the blended rows in frame order, the old keys are still in place to blend from
+	TArray<TArray<meshOpacityCache> > new_table;
+	TArray<int32> new_key_frames;
+	new_table.Reserve(key_frames.Num() + new_frames.Num());
+	new_key_frames.Reserve(key_frames.Num() + new_frames.Num());
+
+	int32 old_idx = 0;
+	for (auto cur_frame : new_frames) {
+		while ((old_idx < key_frames.Num()) && (key_frames[old_idx] < cur_frame)) {
+			new_table.Add(opacity_cache_table[old_idx]);
+			new_key_frames.Add(key_frames[old_idx]);
+			old_idx++;
+		}
+
+		int32 base_key, end_key;
+		float ratio;
+		findCacheKeys(key_frames, frame_keys, (float)cur_frame, base_key, end_key, ratio);
+
+		const TArray<meshOpacityCache>& base_cache = opacity_cache_table[base_key];
+		const TArray<meshOpacityCache>& end_cache = opacity_cache_table[end_key];
+		TArray<meshOpacityCache>& new_cache = new_table.AddDefaulted_GetRef();
+		new_cache.Reserve(base_cache.Num());
+		for (auto i = 0; i < base_cache.Num(); i++) {
+			const meshOpacityCache& base_data = base_cache[i];
+			const meshOpacityCache& end_data = end_cache[i];
+			meshOpacityCache new_data(base_data.getKey());
+			new_data.setOpacity(FMath::Lerp(base_data.getOpacity(), end_data.getOpacity(), ratio));
+			new_data.setRed(FMath::Lerp(base_data.getRed(), end_data.getRed(), ratio));
+			new_data.setGreen(FMath::Lerp(base_data.getGreen(), end_data.getGreen(), ratio));
+			new_data.setBlue(FMath::Lerp(base_data.getBlue(), end_data.getBlue(), ratio));
+			new_cache.Add(new_data);
+		}
+
+		new_key_frames.Add(cur_frame);
+	}
+
+	for (; old_idx < key_frames.Num(); old_idx++) {
+		new_table.Add(opacity_cache_table[old_idx]);
+		new_key_frames.Add(key_frames[old_idx]);
+	}
+
+	opacity_cache_table = MoveTemp(new_table);
+	key_frames = MoveTemp(new_key_frames);
+
+	int32 cur_key = -1;
+	for (auto i = 0; i < frame_keys.Num(); i++) {
+		while (((cur_key + 1) < key_frames.Num()) && (key_frames[cur_key + 1] <= i)) {
+			cur_key++;
+		}
+
+		frame_keys[i] = cur_key;
+	}
+}
+
 int32
 meshOpacityCacheManager::getIndexByTime(int32 time_in) const
 {
 	int32 retval = time_in - start_time;
-	retval = clipNumber(retval, 0, (int32)opacity_cache_table.Num() - 1);
+	retval = clipNumber(retval, 0, (int32)opacity_cache_data_ready.Num() - 1);
 
 	return retval;
 }
@@ -2200,6 +3914,11 @@ void
 meshOpacityCacheManager::setValuesAtTime(int32 time_in,
 						TMap<FName, meshRenderRegion *>& regions_map)
 {
+	if (frame_keys.Num() > 0) {
+		// keys are already compacted
+		return;
+	}
+
 	int32 set_index = getIndexByTime(time_in);
 	TArray<meshOpacityCache> cache_list;
 	for (auto cur_iter : regions_map) {
@@ -2222,31 +3941,27 @@ meshOpacityCacheManager::retrieveValuesAtTime(float time_in,
 {
 	SCOPE_CYCLE_COUNTER(STAT_MeshOpacityCacheManager_retrieveValuesAtTime);
 
-	int32 base_time = getIndexByTime((int32)floorf(time_in));
-	int32 final_time = getIndexByTime((int32)ceilf(time_in));
-
-	if (opacity_cache_data_ready.Num() == 0) {
-		return;
-	}
-
-	if ((opacity_cache_data_ready[base_time] == false)
-		|| (opacity_cache_data_ready[final_time] == false))
-	{
+	// Opacity steps per whole frame, blended between the keys around that frame
+	int32 base_time, final_time;
+	float ratio;
+	if (getKeysAtTime(floorf(time_in), base_time, final_time, ratio) == false) {
 		return;
 	}
 
 	TArray<meshOpacityCache>& base_cache = opacity_cache_table[base_time];
+	TArray<meshOpacityCache>& end_cache = opacity_cache_table[final_time];
 
 	for (auto i = 0; i < base_cache.Num(); i++) {
 		const meshOpacityCache& base_data = base_cache[i];
+		const meshOpacityCache& end_data = end_cache[i];
 		const FName& cur_key = base_data.getKey();
 
 		meshRenderRegion * set_region = regions_map[cur_key];
-		float final_opacity = base_data.getOpacity();
+		float final_opacity = ((1.0f - ratio) * base_data.getOpacity()) + (ratio * end_data.getOpacity());
 		set_region->setOpacity(final_opacity);
-		set_region->setRed(base_data.getRed());
-		set_region->setGreen(base_data.getGreen());
-		set_region->setBlue(base_data.getBlue());
+		set_region->setRed(((1.0f - ratio) * base_data.getRed()) + (ratio * end_data.getRed()));
+		set_region->setGreen(((1.0f - ratio) * base_data.getGreen()) + (ratio * end_data.getGreen()));
+		set_region->setBlue(((1.0f - ratio) * base_data.getBlue()) + (ratio * end_data.getBlue()));
 	}
 }
 
@@ -2255,16 +3970,9 @@ meshOpacityCacheManager::retrieveSingleValueAtTime(float time_in,
 												meshRenderRegion * region,
 												float& out_opacity)
 {
-	int32 base_time = getIndexByTime((int32)floorf(time_in));
-	int32 final_time = getIndexByTime((int32)ceilf(time_in));
-
-	if (opacity_cache_data_ready.Num() == 0) {
-		return;
-	}
-
-	if ((opacity_cache_data_ready[base_time] == false)
-		|| (opacity_cache_data_ready[final_time] == false))
-	{
+	int32 base_time, final_time;
+	float ratio;
+	if (getKeysAtTime(floorf(time_in), base_time, final_time, ratio) == false) {
 		return;
 	}
 
@@ -2279,7 +3987,7 @@ meshOpacityCacheManager::retrieveSingleValueAtTime(float time_in,
 
 		meshRenderRegion * set_region = region;
 		if (cur_key == set_region->getName()) {
-			out_opacity = base_data.getOpacity();
+			out_opacity = ((1.0f - ratio) * base_data.getOpacity()) + (ratio * end_data.getOpacity());
 
 			break;
 		}
@@ -17,6 +17,14 @@ struct FCreatureAnimationDataCache
 	UPROPERTY()
 	TArray<float> m_points;
 
+	// Serialized quantized point cache, used instead of m_points when point cache compression is on
+	UPROPERTY()
+	TArray<uint8> m_compressedPoints;
+
+	// Frame of each cached sample when the point cache was sampled adaptively, empty otherwise
+	UPROPERTY()
+	TArray<int32> m_sampleFrames;
+
 	UPROPERTY()
 	int32 m_numArrays;
 
@@ -48,14 +56,40 @@ public:
 	UPROPERTY()
 	FString CreatureRawJSONString;
 
+	// Compiled binary creature data, generated from the JSON on import
+	UPROPERTY()
+	TArray<uint8> CreatureCompiledBinary;
+
 	FString& GetJsonString();
 
+	// Returns the zlib compressed json or nullptr if the asset stores it uncompressed
+	const TArray<uint8>* GetCompressedJson() const;
+
+	// Returns the compiled binary data or nullptr if none is available
+	const TArray<uint8>* GetCompiledBinary() const;
+
 	void SetNewJsonString(FString& str_in);
 	
 	/** The approximation level to use when generating the point cache (range 0-20; 0=no approximation, -1=no cache generated) */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Creature)
 	int32 m_pointsCacheApproximationLevel;
 
+	/** Stores the point cache as 16 bit quantized key frames plus 8 bit delta frames, a fraction of the float cache size */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Creature)
+	bool m_compressPointsCache = false;
+
+	/** Largest distance a cached point may be off its posed position, samples are then picked per clip instead of by approximation level (0=off) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Creature, meta=(ClampMin="0.0"))
+	float m_pointsCacheMaxError = 0.0f;
+
+	/** Largest distance a bone may be off its exported position when the compiled bone tracks are compressed (0=no compression) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Creature, meta=(ClampMin="0.0"))
+	float m_bonesCompressionTolerance = 0.0f;
+
+	/** Largest distance a mesh deformation point may be off its exported position when displacements are stored as basis shapes (0=no compression) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Creature, meta=(ClampMin="0.0"))
+	float m_displacementsCompressionTolerance = 0.0f;
+
 	const FCreatureAnimationDataCache *GetDataCacheForClip(const FName & clipName) const;
 
 	float GetClipLength(const FName & clipName) const;
@@ -68,6 +102,8 @@ public:
 
 	virtual void Serialize(FArchive& Ar) override;
 
+	virtual void BeginDestroy() override;
+
 #if WITH_EDITORONLY_DATA
 	FName UpdateAndGetCreatureFilename();
 	void SetCreatureFilename(const FName &newFilename);
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Layout of the compiled binary creature format.
+// Everything is stored as flat, 16 byte aligned blocks of plain structs so the data can be
+// memory mapped and read in place. All offsets are in bytes from the start of the file.
+namespace CreatureModule {
+namespace CreatureBinary {
+
+	// 'CRBN'
+	static const uint32 Magic = 0x4E425243;
+	// Bump this whenever the layout below changes
+	static const uint32 Version = 5;
+	static const uint32 Alignment = 16;
+	// Influences stored per point, matches meshRenderRegionWeights::max_influences
+	static const int32 MaxInfluences = 8;
+
+	enum ClipFlags
+	{
+		ClipHasOpacity = 1 << 0,
+		// Bones are stored as BoneTrackEntry tracks instead of bone frames and keys
+		ClipHasCompressedBones = 1 << 1,
+		// Displacements are stored as DisplacementTrackEntry basis tracks instead of displacement frames and keys
+		ClipHasDisplacementBasis = 1 << 2
+	};
+
+	struct FileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 header_size;
+		uint32 total_size;
+
+		int32 num_pts;
+		int32 num_indices;
+		int32 num_bones;
+		int32 num_regions;
+		int32 num_names;
+		int32 num_animation_names;
+		int32 num_uv_swap_items;
+		int32 num_anchor_points;
+		int32 num_clips;
+
+		uint32 names_offset;			// NameEntry[num_names]
+		uint32 points_offset;			// float[num_pts * 3], x y z
+		uint32 indices_offset;			// uint32[num_indices]
+		uint32 uvs_offset;				// float[num_pts * 2]
+		uint32 bones_offset;			// BoneEntry[num_bones], parents always come before children
+		uint32 regions_offset;			// RegionEntry[num_regions]
+		uint32 animation_names_offset;	// int32[num_animation_names], name indices
+		uint32 uv_swap_items_offset;	// UVSwapEntry[num_uv_swap_items]
+		uint32 anchor_points_offset;	// AnchorPointEntry[num_anchor_points]
+		uint32 clips_offset;			// ClipEntry[num_clips]
+	};
+
+	struct NameEntry
+	{
+		uint32 chars_offset;			// UTF-8, not null terminated
+		uint32 num_chars;
+	};
+
+	struct BoneEntry
+	{
+		int32 name_idx;
+		int32 tag_id;
+		int32 parent_slot;				// -1 for the root bone
+		int32 padding;
+		float rest_parent_mat[16];
+		float local_rest_start_pt[2];
+		float local_rest_end_pt[2];
+	};
+
+	struct RegionEntry
+	{
+		int32 name_idx;
+		int32 tag_id;
+		int32 start_pt_index;
+		int32 end_pt_index;
+		int32 start_index;
+		int32 end_index;
+		int32 num_influence_bones;
+		uint32 influence_bones_offset;	// int32[num_influence_bones], name indices of the bones InfluenceEntry::bone_index points at
+		uint32 influences_offset;		// InfluenceEntry[region num pts][MaxInfluences], strongest first
+		uint32 influence_counts_offset;	// uint8[region num pts], used influences per point
+		int32 padding[2];
+	};
+
+	struct InfluenceEntry
+	{
+		uint16 bone_index;
+		uint16 padding;
+		float weight;
+	};
+
+	struct UVSwapEntry
+	{
+		int32 region_name_idx;
+		int32 tag;
+		float local_offset[2];
+		float global_offset[2];
+		float scale[2];
+	};
+
+	struct AnchorPointEntry
+	{
+		int32 clip_name_idx;
+		float point[2];
+		int32 padding;
+	};
+
+	// Per frame range into one of the key arrays of a clip
+	struct FrameEntry
+	{
+		uint32 first_key;
+		uint32 num_keys;
+	};
+
+	struct ClipEntry
+	{
+		int32 name_idx;
+		int32 start_time;
+		int32 end_time;
+		uint32 flags;
+
+		// One FrameEntry per frame in [start_time, end_time], frames without a key have no keys
+		// and are interpolated from the keys around them
+		uint32 bone_frames_offset;			// FrameEntry[num_frames]
+		uint32 bone_keys_offset;			// BoneKey[]
+		uint32 displacement_frames_offset;	// FrameEntry[num_frames]
+		uint32 displacement_keys_offset;	// DisplacementKey[]
+		uint32 uv_frames_offset;			// FrameEntry[num_frames]
+		uint32 uv_keys_offset;				// UVWarpKey[]
+		uint32 opacity_frames_offset;		// FrameEntry[num_frames]
+		uint32 opacity_keys_offset;			// OpacityKey[]
+
+		int32 num_bone_tracks;
+		uint32 bone_tracks_offset;			// BoneTrackEntry[num_bone_tracks]
+		uint32 bone_track_frames_offset;	// uint16[], kept key frames of all tracks
+		uint32 bone_track_values_offset;	// uint16[][4], quantized kept key values of all tracks
+
+		int32 num_displacement_tracks;
+		int32 num_displacement_key_frames;
+		uint32 displacement_tracks_offset;		// DisplacementTrackEntry[num_displacement_tracks]
+		uint32 displacement_key_frames_offset;	// int32[num_displacement_key_frames], frame offsets of the keys
+		uint32 displacement_basis_offset;		// float[], mean and basis shapes of all tracks
+		uint32 displacement_coeffs_offset;		// float[], per key basis coefficients of all tracks
+	};
+
+	struct BoneKey
+	{
+		int32 name_idx;
+		float start_pt[2];
+		float end_pt[2];
+	};
+
+	// Lossy compressed bone track, see meshBoneCompressedTrack
+	struct BoneTrackEntry
+	{
+		int32 name_idx;
+		int32 first_key;
+		int32 num_keys;
+		int32 padding;
+		float bounds_min[4];
+		float bounds_step[4];
+	};
+
+	// Basis compressed displacement track, see meshDisplacementBasisTrack
+	struct DisplacementTrackEntry
+	{
+		int32 name_idx;
+		int32 num_local_pts;
+		int32 num_post_pts;
+		int32 num_basis;
+		int32 basis_offset;				// in floats from displacement_basis_offset
+		int32 coeffs_offset;			// in floats from displacement_coeffs_offset
+	};
+
+	struct DisplacementKey
+	{
+		int32 name_idx;
+		int32 num_local_pts;
+		int32 num_post_pts;
+		uint32 pts_offset;				// float[(num_local_pts + num_post_pts) * 2], local first
+	};
+
+	struct UVWarpKey
+	{
+		int32 name_idx;
+		int32 enabled;
+		int32 level;
+		float local_offset[2];
+		float global_offset[2];
+		float scale[2];
+	};
+
+	struct OpacityKey
+	{
+		int32 name_idx;
+		float opacity;
+		float red, green, blue;
+	};
+
+	inline int32 GetNumFrames(const ClipEntry& clip_in)
+	{
+		return clip_in.end_time - clip_in.start_time + 1;
+	}
+}
+}
@@ -62,6 +62,20 @@ struct FCreatureBoneData
 	FName name;
 };
 
+// Where the data of a creature gets loaded from, resolved on the game thread so the loading itself can run anywhere
+struct FCreatureLoadRequest
+{
+	// Name the loaded data is registered under, None when there is nothing to load
+	FName load_filename;
+	FString* pJsonData = nullptr;
+	const TArray<uint8>* pBinaryData = nullptr;
+	const TArray<uint8>* pZipJsonData = nullptr;
+	// Copies the pointers above point into once the request is handed to another thread,
+	// so the source asset can change or go away while it loads
+	TSharedPtr<FString, ESPMode::ThreadSafe> owned_json;
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> owned_bytes;
+};
+
 class CreatureCore;
 class CreatureMeshDataModifier
 {
@@ -100,6 +114,20 @@ public:
 
 	bool InitCreatureRender();
 
+	// Resolves where InitCreatureRender loads the creature from
+	FCreatureLoadRequest MakeLoadRequest();
+
+	// Parses the requested data and builds its prototype and all of its animations into the shared registries,
+	// safe to call from any thread. InitCreatureRender then only instances the already loaded creature
+	static bool LoadCreatureData(const FCreatureLoadRequest& request);
+
+	// Runs LoadCreatureData on a background thread on a copy of the request's source data,
+	// on_done gets its result on the game thread
+	static void LoadCreatureDataAsync(const FCreatureLoadRequest& request, TFunction<void(bool)> on_done);
+
+	// Whether LoadCreatureData has already completed for this request
+	static bool IsCreatureDataLoaded(const FCreatureLoadRequest& request);
+
 	void InitValues();
 
 	void FillBoneData();
@@ -116,6 +144,17 @@ public:
 	// Loads a data packet from a string in memory
 	static bool LoadDataPacket(const FName& filename_in,FString* pSourceData);
 
+	// Loads a data packet from a compiled binary buffer in memory. The buffer is read in place, so its owner
+	// has to free the packet with FreeBinaryDataPackets before it changes or frees it, unless the packet owns it
+	static bool LoadDataPacket(const FName& filename_in, const TArray<uint8>* pBinarySource,
+		const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& pSourceOwner = nullptr);
+
+	// Loads a data packet from a zlib compressed json buffer in memory, inflated straight into the parse buffer
+	static bool LoadCompressedDataPacket(const FName& filename_in, const TArray<uint8>* pZipSource);
+
+	// Compiles a loaded data packet into the binary creature format, tolerances > 0 compress the bone and displacement tracks
+	static bool CompileDataPacket(const FName& filename_in, TArray<uint8>& binary_out, float bone_tolerance = 0.0f, float displacement_tolerance = 0.0f);
+
 	// Frees up memory from loading the data packets, this will force the reparsing of JSON strings if
 	// the asset is requested again
 	static void ClearAllDataPackets();
@@ -124,10 +163,16 @@ public:
 	// the asset is requested again
 	static void FreeDataPacket(const FName& filename_in);
 
+	// Frees the data packets that read pBinarySource in place, for when its owner changes or frees it
+	static void FreeBinaryDataPackets(const TArray<uint8>* pBinarySource);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Loads an animation from a file
 	static void LoadAnimation(const FName& filename_in, const FName& name_in);
 
+	// Stops the shared animations from reading their point cache in place from pts_in, for when the owner of pts_in goes away
+	static void UnbindPointCache(const glm::float32 * pts_in);
+
 	// Loads the creature character from a file
 	TArray<FProceduralMeshTriangle>& LoadCreature(const FName& filename_in);
 
@@ -202,6 +247,40 @@ public:
 
 	bool GetGlobalEnablePointCache();
 
+	// Only poses bones and runs events, the render points are left as they are
+	void SetBonesOnlyUpdate(bool flag_in);
+
+	// Blends bones instead of skinned points when two animations blend, skinning once per update
+	void SetBoneSpaceBlending(bool flag_in);
+
+	bool GetBoneSpaceBlending();
+
+	// Sets the blend graph, which plays weighted clips and layers instead of the active animation
+	void SetBlendGraph(const TArray<CreatureModule::CreatureBlendClip>& clips_in,
+		const TArray<CreatureModule::CreatureBlendLayer>& layers_in);
+
+	void ClearBlendGraph();
+
+	// Bakes the final points, uvs, colours and index order of every frame of a clip. With can_share_in,
+	// instances of the same character with the same skin, colours, region order, item swaps and mirroring
+	// share one bake. Pass false when bone overrides or IK change the pose, those bakes stay private.
+	bool BakeClip(const FName& name_in, bool can_share_in = true);
+
+	void ClearBakedClip(const FName& name_in);
+
+	// Plays clips that have been baked straight from their baked frames, without touching the rig.
+	// Bones are not posed, blends and morph targets fall back to the regular update.
+	void SetBakedPlayback(bool flag_in);
+
+	bool GetBakedPlayback() const;
+
+	bool CanPlayBakedClip();
+
+	void ApplyBakedFrame();
+
+	// Identifies everything a bake of the clip depends on, empty if the bake can not be shared
+	FString GetBakedClipKey(const FName& name_in);
+
 	glm::uint32 * GetIndicesCopy(int init_size);
 
 	int32 GetRealTotalIndicesNum() const;
@@ -239,6 +318,11 @@ public:
 	bool play_start_done, play_end_done;
 	bool is_disabled;
 	bool is_driven;
+	bool bones_only_update;
+	bool use_baked_playback;
+	// Baked clips by animation name. They capture this instance's skins, colours, region order
+	// and bone overrides, instances only share them when all of those match
+	TMap<FName, TSharedPtr<CreatureModule::CreatureBakedClip, ESPMode::ThreadSafe> > baked_clips;
 	bool is_ready_play;
 	bool is_animation_loaded;
 	bool should_process_animation_start, should_process_animation_end;
@@ -254,6 +338,8 @@ public:
 
 	bool bUsingCreatureAnimatinAsset=false;
 	FString* pJsonData;
+	const TArray<uint8>* pBinaryData;
+	const TArray<uint8>* pZipJsonData;
 	CreatureMetaData * meta_data;
 	glm::uint32 * global_indices_copy;
 	bool skin_swap_active;
@@ -44,9 +44,18 @@
 #include "CreatureMetaAsset.h"
 #include "CreatureParticlesAsset.h"
 #include "CreatureCore.h"
-#include "Async/Future.h"
 #include "CreatureMeshComponent.generated.h"
 
+/** How much animation work a creature component does this frame */
+UENUM(BlueprintType)
+enum class ECreatureAnimationLOD : uint8
+{
+	Full,
+	ReducedRate,
+	PointCacheOnly,
+	BonesOnly
+};
+
 USTRUCT(BlueprintType)
 struct FCreatureMeshCollectionToken
 {
@@ -161,6 +170,49 @@ struct FCreatureBoneIK  {
 	bool children_ready;
 };
 
+USTRUCT(BlueprintType)
+struct FCreatureBlendGraphClip {
+	GENERATED_USTRUCT_BODY()
+	FCreatureBlendGraphClip()
+		: weight(1.0f)
+	{
+	}
+
+	/** Name of the animation to play */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	FName animation_name;
+
+	/** Weight of the animation, weights of all clips are normalised */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	float weight;
+};
+
+USTRUCT(BlueprintType)
+struct FCreatureBlendGraphLayer {
+	GENERATED_USTRUCT_BODY()
+	FCreatureBlendGraphLayer()
+		: weight(1.0f), additive(false)
+	{
+	}
+
+	/** Name of the animation applied by this layer */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	FName animation_name;
+
+	/** Weight of the layer, from 0 to 1 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	float weight;
+
+	/** Adds the offset of the animation from its first frame instead of blending towards it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature",
+		meta = (MakeStructureDefaultValue = "false"))
+	bool additive;
+
+	/** Per bone weights of the layer. Bones that are missing are left alone, an empty mask affects every bone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	TMap<FName, float> bone_mask;
+};
+
 // Frame/Time Event callback structs
 USTRUCT(BlueprintType)
 struct FCreatureFrameCallback {
@@ -263,38 +315,6 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCreatureMeshAnimationEndEvent, floa
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCreatureFrameCallbackEvent, FName, name);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCreatureRepeatFrameCallbackEvent, FName, name);
 
-/**
-* Tick function that processes the results of the creature core update
-**/
-USTRUCT(BlueprintType)
-struct FCreatureCoreResultTickFunction : public FTickFunction
-{
-	GENERATED_USTRUCT_BODY()
-
-	class UCreatureMeshComponent*	Target;
-
-	/**
-	* Abstract function to execute the tick.
-	* @param DeltaTime - frame time to advance, in seconds.
-	* @param TickType - kind of tick for this frame.
-	* @param CurrentThread - thread we are executing on, useful to pass along as new tasks are created.
-	* @param MyCompletionGraphEvent - completion event for this task. Useful for holding the completetion of this task until certain child tasks are complete.
-	*/
-	virtual void ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
-	/** Abstract function to describe this tick. Used to print messages about illegal cycles in the dependency graph. */
-	virtual FString DiagnosticMessage() override;
-};
-
-template<>
-struct TStructOpsTypeTraits<FCreatureCoreResultTickFunction> : public TStructOpsTypeTraitsBase2<FCreatureCoreResultTickFunction>
-{
-	enum
-	{
-		WithCopy = false
-	};
-};
-
-
 /** Component that allows you to specify custom triangle mesh geometry */
 //////////////////////////////////////////////////////////////////////////
 //Changed by god of pen
@@ -392,9 +412,8 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
 	float fixed_timestep;
 
-	// Decides whether to run parallel processing per whole character. Note this
-	// is not neccessarily safe to do if you are going to delete this character dynamically.
-	// It is safe to enable for characters that have more or less constant lifetimes and not deleted.
+	// Decides whether to run parallel processing per whole character. All characters with this
+	// enabled are updated together in one parallel batch per world, after the component ticks.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
 	bool run_task_multicore;
 
@@ -402,6 +421,41 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
 	bool use_anchor_points;
 
+	/** Loads a creature that is not loaded yet on a background thread instead of on register, the character shows up once it is loaded */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature")
+	bool load_async;
+
+	/** Lowers the animation work based on screen size and visibility. The creature.AnimLOD console variable can force this on or off for all components */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	bool enable_animation_lod;
+
+	/** Below this screen size the animation only updates every lod_reduced_rate_frames frames.
+	  * Screen size is the bounds diameter over the screen size from the closest player camera, as for static mesh LODs */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	float lod_reduced_rate_screen_size;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	int32 lod_reduced_rate_frames;
+
+	/** Below this screen size the animation plays from point caches only, clips without a point cache are still skinned */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	float lod_point_cache_screen_size;
+
+	/** Only poses bones and fires events while the character is not rendered */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	bool lod_offscreen_bones_only;
+
+	/** Scales the screen size when ranking this character against others for the creature.AnimLODBudgetMs budget */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Components|Creature|LOD")
+	float lod_significance_scale;
+
+	/** Current animation LOD of this component */
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature|LOD")
+	ECreatureAnimationLOD GetAnimationLOD() const;
+
+	// Update interval multiplier from the world LOD budget, applies to the next update only
+	void SetLODBudgetInterval(int32 interval_in);
+
 
 	/** Event that is triggered when the animation starts */
 	UPROPERTY(BlueprintAssignable, Category = "Components|Creature")
@@ -485,6 +539,48 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
 	bool GetBluePrintUsePointCache();
 
+	// Blueprint function to blend bones instead of skinned points when blending between two animations.
+	// Only one skinning pass runs per update, which is cheaper for large characters. Point cached
+	// animations keep blending their points. Off by default.
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	void SetBluePrintBoneSpaceBlending(bool flag_in);
+
+	// Blueprint function that returns whether blends are done in bone space
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	bool GetBluePrintBoneSpaceBlending();
+
+	// Blueprint function to play weighted clips with layers on top, blended in bone space, instead of the
+	// active animation. Layers are applied in order. Morph targets take precedence over the blend graph.
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	void SetBluePrintBlendGraph(const TArray<FCreatureBlendGraphClip>& clips_in, const TArray<FCreatureBlendGraphLayer>& layers_in);
+
+	// Blueprint function to clear the blend graph and go back to playing the active animation
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	void ClearBluePrintBlendGraph();
+
+	// Blueprint function to bake the final points, uvs, colours and region order of every frame of an animation.
+	// Baked animations play without posing the character at all, which suits background characters.
+	// A bake holds every frame's points, uvs and colours, so it costs memory per frame and per point.
+	// Meshes of the same character with the same skin, region colours, region order, item swaps and
+	// mirroring share one bake. Meshes with bone overrides or IK bake their own copy, so baking those
+	// on every mesh of a crowd grows memory with the crowd size.
+	// Returns false if the animation does not exist or the character is currently blending.
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	bool BakeBluePrintClip_Name(FName name_in);
+
+	// Blueprint function to clear the baked frames of a given animation
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	void ClearBluePrintBakedClip_Name(FName name_in);
+
+	// Blueprint function to enable/disable playing baked animations from their baked frames. Bones are not
+	// posed while a baked animation plays, blends and morph targets always use the regular update.
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	void SetBluePrintUseBakedPlayback(bool flag_in);
+
+	// Blueprint function that returns whether this mesh plays baked animations from their baked frames
+	UFUNCTION(BlueprintCallable, Category = "Components|Creature")
+	bool GetBluePrintUseBakedPlayback();
+
 	// Blueprint function that returns the transform given a bone name, position_slide_factor
 	// determines how far left or right the transform is placed. The default value of 0 places it
 	// in the center of the bone, positve values places it to the right, negative to the left
@@ -672,8 +768,6 @@ public:
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
 	virtual void OnRegister() override;
-	virtual void RegisterComponentTickFunctions(bool bRegister) override;
-	void RegisterCoreResultsTickFunction(bool bRegister);
 
 	virtual void InitializeComponent() override;
 
@@ -718,17 +812,26 @@ protected:
 
 	void RunTick(float DeltaTime);
 
+	// Picks the animation LOD, returns false if this frame's update is skipped.
+	// Skipped time is accumulated into delta_time of the next update.
+	bool UpdateAnimationLOD(float& delta_time);
+
+	float ComputeLODScreenSize() const;
+
 	void RunCollectionTick(float DeltaTime);
 
 	void FireStartEndEvents();
 
 	bool RunTickProcessing(float DeltaTime, bool markDirty);
 
-	/** Update systems */
-	void ProcessCreatureCoreResult(FCreatureCoreResultTickFunction& ThisTickFunction);
+	/** Marks render data dirty and fires events after a batched update */
+	void PublishCreatureCoreResult();
 
 	void StandardInit();
 
+	// Starts loading the creature data in the background, returns false if there is nothing to wait for
+	bool StartAsyncLoad();
+
 	void CollectionInit();
 
 	void SwitchToCollectionClip(FCreatureMeshCollectionClip * clip_in);
@@ -762,10 +865,14 @@ protected:
 
 	void TryEnableParticles();
 
-	// future used for async creature processing
-	TFuture<bool> creatureTickResult;
-
-	FCreatureCoreResultTickFunction EndPhysicsTickFunction;
-	friend struct FCreatureCoreResultTickFunction;
+	ECreatureAnimationLOD animation_lod;
+	int32 lod_frame_counter;
+	float lod_skipped_time;
+	// Update interval multiplier handed out by the world LOD budget, reset to 1 on every report
+	int32 lod_budget_interval;
+	// Running average of the update cost in ms
+	float lod_update_cost;
+	// Bumped by every init, a background load only finishes the init that started it
+	int32 async_load_serial;
 
 };
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
 #include "Components/BoxComponent.h"
+#include "CreatureModule.h"
 #include "CreatureMetaAsset.generated.h"
 
 class meshBone;
@@ -274,9 +275,8 @@ public:
 		TArray<float> weights;
 		FVector2D bounds_min, bounds_max;
 		int morph_res;
-		TArray<TTuple<FName, float>> play_anims_data;
-		TTuple<FName, float> play_center_anim_data;
-		TArray<glm::float32> play_pts;
+		TArray<CreatureModule::CreatureBlendClip> play_clips;
+		TArray<float> play_run_times;
 		FVector2D play_img_pt;
 
 		bool isValid() const {
@@ -44,6 +44,9 @@
 #include <fstream>
 #include <sstream>
 
+class IMappedFileHandle;
+class IMappedFileRegion;
+
 namespace CreatureModule {
     
     class CreatureLoadDataPacket {
@@ -51,36 +54,83 @@ namespace CreatureModule {
         CreatureLoadDataPacket()
         {
             src_chars = NULL;
+            binary_data = NULL;
+            binary_size = 0;
+            mapped_handle = NULL;
+            mapped_region = NULL;
         }
         
-        ~CreatureLoadDataPacket()
+        ~CreatureLoadDataPacket();
+        
+        // Returns whether this packet holds compiled binary data instead of json
+        bool isBinary() const
         {
-            if(src_chars)
-            {
-                delete [] src_chars;
-            }
+            return binary_data != NULL;
         }
         
         JsonValue base_node;
         JsonAllocator allocator;
         char * src_chars;
+        
+        // Clip nodes of the parsed json by name, built once after parsing
+        TMap<FName, JsonNode *> json_clips;
+        
+        // Compiled binary data, either memory mapped, owned by binary_storage or read in place from a buffer
+        const uint8 * binary_data;
+        int64 binary_size;
+        TArray<uint8> binary_storage;
+        // Keeps the buffer read in place alive when the packet is its only user
+        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> binary_owner;
+        TArray<FName> binary_names;
+        IMappedFileHandle * mapped_handle;
+        IMappedFileRegion * mapped_region;
     };
     
     // Opens the json file and returns the entire json structure for a creature
-    // Use this to load your creatures and animatons
-    void LoadCreatureJSONData(const FName& filename_in,
+    // Use this to load your creatures and animatons, returns false if the file can not be read or parsed
+    bool LoadCreatureJSONData(const FName& filename_in,
                               CreatureLoadDataPacket& load_data);
     
     // Opens the json file compressed in .zip format and returns the entire json structure for a creature
-    // Use this to load your creatures and animatons
-    void LoadCreatureZipJSONData(const FName& filename_in,
+    // Use this to load your creatures and animatons, returns false if the file can not be extracted or parsed
+    bool LoadCreatureZipJSONData(const FName& filename_in,
                                  CreatureLoadDataPacket& load_data);
     
     // Parses and creates a json from an input string and returns the entire json structure for a creature
-    // Use this to load your creatures and animatons
-    void LoadCreatureJSONDataFromString(const FString& string_in,
+    // Use this to load your creatures and animatons, returns false if the string can not be parsed
+    bool LoadCreatureJSONDataFromString(const FString& string_in,
+                                        CreatureLoadDataPacket& load_data);
+    
+    // Inflates a zlib compressed json byte array ( as saved by FArchiveSaveCompressedProxy ) straight into
+    // the parse buffer, without going through an FString
+    bool LoadCreatureJSONDataFromCompressedBuffer(const TArray<uint8>& data_in,
+                                                  CreatureLoadDataPacket& load_data);
+    
+    // Parses a null terminated utf-8 json buffer in place, load_data takes ownership of the new[] allocated buffer
+    bool LoadCreatureJSONDataFromBuffer(char * chars_in,
                                         CreatureLoadDataPacket& load_data);
 
+    // Memory maps a compiled binary creature file ( see CompileCreatureBinaryData )
+    // Use this to load your creatures and animations without any json parsing
+    bool LoadCreatureBinaryData(const FName& filename_in,
+                                CreatureLoadDataPacket& load_data);
+    
+    // Readies a compiled binary creature buffer for loading. The buffer is read in place, no copy is made,
+    // so it has to outlive the packet or be handed to its binary_owner
+    bool LoadCreatureBinaryDataFromBuffer(const TArray<uint8>& data_in,
+                                          CreatureLoadDataPacket& load_data);
+    
+    // Converts a loaded json creature into the compiled binary format
+    // A bone_tolerance above 0 lossy compresses the bone tracks, bones then stay within that distance of the exported ones
+    // A displacement_tolerance above 0 stores displacements as basis shapes, points then stay within that distance
+    bool CompileCreatureBinaryData(CreatureLoadDataPacket& load_data,
+                                   TArray<uint8>& data_out,
+                                   float bone_tolerance = 0.0f,
+                                   float displacement_tolerance = 0.0f);
+    
+    // Returns whether the input buffer is a compiled binary creature of the current version
+    bool IsCreatureBinaryData(const uint8 * data_in, int64 size_in);
+
 	struct CreatureUVSwapPacket {
 		CreatureUVSwapPacket(const glm::vec2& local_offset_in,
 			const glm::vec2& global_offset_in,
@@ -99,11 +149,32 @@ namespace CreatureModule {
 		int32 tag;
 	};
     
+    // Rest mesh data that never changes after loading, shared between a creature and its clones
+    class CreatureMeshData {
+    public:
+        CreatureMeshData(glm::uint32 * indices_in, glm::float32 * pts_in)
+        : global_indices(indices_in), global_pts(pts_in)
+        {}
+        
+        ~CreatureMeshData()
+        {
+            delete [] global_indices;
+            delete [] global_pts;
+        }
+        
+        glm::uint32 * global_indices;
+        glm::float32 * global_pts;
+    };
+    
     // Class for the creature character
     class Creature {
     public:
         Creature(CreatureLoadDataPacket& load_data);
         
+        // Clones a creature from a loaded prototype. The rest mesh, skeleton topology
+        // and region weights are shared, only the per instance pose state is copied.
+        Creature(const Creature& prototype_in);
+        
         virtual ~Creature();
         
         // Fills entire mesh with (r,g,b,a) colours
@@ -156,10 +227,17 @@ namespace CreatureModule {
 
 		// Returns an Anchor Point based on an input animation clip name
 		glm::vec2 GetAnchorPoint(const FName& anim_clip_name_in) const;
+
+		// Returns all Anchor Points
+		const TMap<FName, glm::vec2>& GetAnchorPointMap() const;
     
     protected:
         
         void LoadFromData(CreatureLoadDataPacket& load_data);
+
+        void LoadFromBinaryData(CreatureLoadDataPacket& load_data);
+
+        void InitRenderComposition(meshBone * root_bone, TArray<meshRenderRegion *>& regions);
         
         // mesh and skeleton data
         glm::uint32 * global_indices;
@@ -167,6 +245,7 @@ namespace CreatureModule {
         glm::float32 * render_pts;
         glm::uint8 * render_colours;
         int32 total_num_pts, total_num_indices;
+        TSharedPtr<CreatureMeshData> shared_mesh;
         meshRenderBoneComposition * render_composition;
         TArray<FName> animation_names;
 		TMap<FName, TArray<CreatureUVSwapPacket> > uv_swap_packets;
@@ -176,6 +255,71 @@ namespace CreatureModule {
     };
     
     // Class for animating the creature character
+    // Point cache stored as 16 bit positions quantized to the clip bounds. Each frame is either
+    // a key frame or 8 bit deltas from its key frame, so any frame decodes in a single step.
+    class CreatureCompressedPointCache {
+    public:
+        CreatureCompressedPointCache();
+        
+        // Quantizes the float frames, a new key frame starts every keyframe_interval frames
+        // or whenever a delta does not fit in 8 bits
+        void compress(const TArray<glm::float32 *>& frames_in,
+                      int32 num_floats_in,
+                      int32 keyframe_interval);
+        
+        void clear();
+        
+        bool isEmpty() const;
+        
+        int32 getNumFrames() const;
+        
+        SIZE_T getAllocatedSize() const;
+        
+        // Dequantizes and lerps two frames straight into target_pts, which holds num_target_floats floats.
+        // Nothing is written when the cache holds a different number of floats.
+        void decode(int32 floor_idx,
+                    int32 ceil_idx,
+                    float ratio,
+                    glm::float32 * target_pts,
+                    int32 num_target_floats) const;
+        
+        void serialize(FArchive& ar);
+        
+        // Whether the cache holds num_floats_in floats per frame and every frame offset lies inside the key
+        // and delta data, check this before decoding a cache that was serialized in
+        bool isValid(int32 num_floats_in) const;
+        
+    protected:
+        
+        void gatherFrame(int32 frame_idx, int32 start_idx, int32 count, float * out_vals) const;
+        
+        int32 num_floats;
+        float bounds_min[3];
+        float bounds_step[3];
+        // Per frame offsets into key_data and delta_data, delta offset is -1 for key frames
+        TArray<int32> frame_key_offsets;
+        TArray<int32> frame_delta_offsets;
+        TArray<uint16> key_data;
+        TArray<int8> delta_data;
+    };
+    
+    // Final render data of a clip, one entry per frame from the clip start, so playback
+    // never touches the rig. Index orders are only stored when they change between frames.
+    struct CreatureBakedClip
+    {
+        CreatureBakedClip()
+        : num_frames(0), num_pts(0)
+        {}
+
+        int32 num_frames;
+        int32 num_pts;
+        TArray<glm::float32> pts;           // num_pts * 3 per frame
+        TArray<glm::float32> uvs;           // num_pts * 2 per frame
+        TArray<FColor> colors;              // num_pts per frame
+        TArray<TArray<glm::uint32> > index_orders;
+        TArray<int32> frame_index_orders;   // per frame index into index_orders, -1 for the default order
+    };
+    
     class CreatureAnimation {
     public:
         CreatureAnimation(CreatureLoadDataPacket& load_data,
@@ -211,14 +355,42 @@ namespace CreatureModule {
 
 		void clearCachePts();
         
+        // Moves the float point cache into the compressed cache
+        void compressCachePts(int32 num_floats, int32 keyframe_interval);
+        
+        CreatureCompressedPointCache& getCompressedCachePts();
+        
+        // Reads the point cache in place from num_frames contiguous frames, stride floats apart.
+        // No copy is made, so the memory has to outlive the binding or the next clearCachePts.
+        void bindCachePts(const glm::float32 * frames_in, int32 num_frames, int32 stride);
+        
+        // Drops the binding if it reads from frames_in, call before that memory goes away
+        void unbindCachePts(const glm::float32 * frames_in);
+        
+        const glm::float32 * getCacheFrame(int32 frame_idx) const;
+        
+        // Frames, relative to the start time, that each cached sample was posed at.
+        // Empty when the cache has one sample per frame.
+        void setCacheSampleFrames(const TArray<int32>& frames_in);
+        
+        const TArray<int32>& getCacheSampleFrames() const;
+        
+        int32 getNumCachePts() const;
+        
         void poseFromCachePts(float time_in, glm::float32 * target_pts, int32 num_pts);
         
     protected:
         
         void LoadFromData(const FName& name_in,
                           CreatureLoadDataPacket& load_data);
+
+        void LoadFromBinaryData(const FName& name_in,
+                                CreatureLoadDataPacket& load_data);
         
         int32 getIndexByTime(int32 time_in) const;
+        
+        // Finds the two cached samples around time_in and the lerp factor between them
+        void getCacheSamples(float time_in, int32& floor_idx, int32& ceil_idx, float& ratio) const;
 
         FName name;
         float start_time, end_time;
@@ -227,8 +399,43 @@ namespace CreatureModule {
         meshUVWarpCacheManager uv_warp_cache;
 		meshOpacityCacheManager opacity_cache;
 		TArray<glm::float32 *> cache_pts;
+        CreatureCompressedPointCache compressed_cache_pts;
+        const glm::float32 * bound_cache_pts;
+        int32 bound_cache_num_frames, bound_cache_stride;
+        TArray<int32> cache_sample_frames;
     };
     
+    // Weighted clip input of the blend graph
+    struct CreatureBlendClip
+    {
+        CreatureBlendClip()
+        : weight(0)
+        {}
+
+        CreatureBlendClip(const FName& animation_name_in, float weight_in)
+        : animation_name(animation_name_in), weight(weight_in)
+        {}
+
+        FName animation_name;
+        float weight;
+    };
+
+    // Layer applied on top of the blended clips, in order.
+    // Override layers lerp towards their clip, additive layers add their clip's offset
+    // from its first frame. Bones missing from a non empty mask are left alone, and
+    // only unmasked override layers touch displacements and colours.
+    struct CreatureBlendLayer
+    {
+        CreatureBlendLayer()
+        : weight(0), additive(false)
+        {}
+
+        FName animation_name;
+        float weight;
+        bool additive;
+        TMap<FName, float> bone_mask;
+    };
+
     // Class for managing a collection of animations and a creature character
     class CreatureManager {
     public:
@@ -284,6 +491,12 @@ namespace CreatureModule {
         
         // Runs a single step of the animation for a given delta timestep
         void Update(float delta);
+
+        // Only steps the run time like Update would, for playback from baked clips
+        void AdvanceTime(float delta);
+
+        // Whether Update poses just the active animation, without any kind of blending
+        bool IsPlayingSingleClip() const;
         
         // Sets scaling for time
         void SetTimeScale(float scale_in);
@@ -299,6 +512,29 @@ namespace CreatureModule {
         
         // Sets the blending factor
         void SetBlendingFactor(float value_in);
+
+        // Blend bones, displacements and opacities before skinning once instead of
+        // skinning both animations and blending the points. Off by default.
+        void SetBoneSpaceBlending(bool flag_in);
+
+        bool GetBoneSpaceBlending() const;
+
+        // Sets the blend graph, which replaces the active animation and the two slot blend
+        // in Update while it has clips. Weights are normalised, tiny ones are skipped.
+        void SetBlendGraph(const TArray<CreatureBlendClip>& clips_in,
+                           const TArray<CreatureBlendLayer>& layers_in);
+
+        void SetBlendGraphClips(const TArray<CreatureBlendClip>& clips_in);
+
+        void ClearBlendGraph();
+
+        bool HasBlendGraph() const;
+
+        // Poses weighted clips like the blend graph but at caller owned run times, one per clip,
+        // which are advanced by delta and looped. The active animation, blends and graph are left alone.
+        void UpdateClips(float delta,
+                         const TArray<CreatureBlendClip>& clips_in,
+                         TArray<float>& run_times_in);
         
         // Given a set of coordinates in local creature space,
         // see if any bone is in contact
@@ -308,6 +544,8 @@ namespace CreatureModule {
         
         // Mirrors the model along the Y-Axis
         void SetMirrorY(bool flag_in);
+
+        bool GetMirrorY() const;
         
         // Decides whether to use a custom time range or the default
         // animation clip's time range
@@ -322,8 +560,10 @@ namespace CreatureModule {
         // Sets the callback to modify/override bone positions
         void SetBonesOverrideCallback(std::function<void (TMap<FName, meshBone *>&) >& callback_in);
         
-        // Creates point cache for animation
-        void MakePointCache(const FName& animation_name_in, int32 gap_step);
+        // Creates point cache for animation. With a max_error above 0 the samples are picked
+        // per clip so that interpolating between them stays within max_error of every frame,
+        // gap_step is ignored then.
+        void MakePointCache(const FName& animation_name_in, int32 gap_step, float max_error = 0.0f);
 
 		// Clears point cache for animation
 		void ClearPointCache(const FName& animation_name_in);
@@ -339,9 +579,19 @@ namespace CreatureModule {
 
 		// Returns whether to globally enable or disable point caching
 		bool GetDoPointCache() const;
+
+		// When set, MakePointCache stores quantized delta frames instead of full float frames
+		void SetCompressPointCache(bool flag_in);
+
+		bool GetCompressPointCache() const;
         
 		// Just poses the bones of the character
 		void PoseJustBones(const FName& animation_name_in, float input_run_time);
+
+		// When set, Update only poses the bones of the active animation and skips skinning
+		void SetBonesOnly(bool flag_in);
+
+		bool GetBonesOnly() const;
     protected:
 
 		bool checkAnimationBlendValid() const;
@@ -356,6 +606,32 @@ namespace CreatureModule {
         void PoseCreature(const FName& animation_name_in,
                           glm::float32 * target_pts,
 						  float input_run_time);
+
+		// Reentrant version of PoseCreature, poses into the given creature instead of target_creature.
+		// Only reads the animation data, so several threads can each pose their own clone at once.
+		void PoseCreatureContext(Creature& pose_creature,
+								 const FName& animation_name_in,
+								 glm::float32 * target_pts,
+								 float input_run_time);
+
+		// Writes bones, displacements and opacities of an animation without skinning
+		void PoseBlendSource(const FName& animation_name_in, float input_run_time);
+
+		// Blends clips and layers in bone space and skins once. Clips are posed at clip_run_times,
+		// one per clip, when given and at the shared blend run times otherwise
+		void PoseBlendGraph(const TArray<CreatureBlendClip>& clips_in,
+							const TArray<CreatureBlendLayer>& layers_in,
+							glm::float32 * target_pts,
+							const TArray<float> * clip_run_times = nullptr);
+
+		// Uv item swaps and mirroring applied to the posed render points
+		void FinishRenderPts();
+
+		void increBlendGraphRuntimes(float delta_in);
+
+		const TArray<glm::vec4>& getAdditiveRefPts(const FName& animation_name_in);
+
+		bool canBoneSpaceBlend() const;
         
         void ProcessAutoBlending();
 
@@ -363,15 +639,23 @@ namespace CreatureModule {
 
 		glm::float32 * interpFloatArray(glm::float32 * first_list, glm::float32 * second_list, float factor, int32 array_size);
 
+		// Whether lerping the first and last frame reproduces every frame in between within max_error
+		bool pointCacheSpanWithinError(const TArray<glm::float32 *>& frames, int32 start_idx, int32 end_idx,
+									   int32 array_size, float max_error) const;
+
 		void ResetBlendTime(const FName& name_in);
 
 		void UpdateRegionSwitches(const FName& animation_name_in);
 
+		void UpdateRegionSwitchesContext(Creature& pose_creature, const FName& animation_name_in);
+
 		void JustRunUVWarps(const FName& animation_name_in, float input_run_time);
 
 		void RunUVItemSwap();
 
 		void AlterBonesByAnchor(TMap<FName, meshBone *>& bones_map, const FName& animation_name_in);
+
+		void AlterBonesByAnchorContext(Creature& pose_creature, TMap<FName, meshBone *>& bones_map, const FName& animation_name_in);
         
         TMap<FName, TSharedPtr<CreatureModule::CreatureAnimation> > animations;
         TSharedPtr<CreatureModule::Creature> target_creature;
@@ -392,6 +676,20 @@ namespace CreatureModule {
         FName auto_blend_names[2];
         float auto_blend_delta;
 		bool do_point_caching;
+		bool do_bone_space_blending;
+		bool bones_only;
+		bool compress_point_cache;
+
+		TArray<CreatureBlendClip> blend_graph_clips;
+		TArray<CreatureBlendLayer> blend_graph_layers;
+		TArray<CreatureBlendClip> blend_pair_clips;
+
+		// Blend graph accumulators, bones by slot and regions by index
+		TArray<glm::vec4> blend_bone_pts;
+		TArray<TArray<glm::vec2> > blend_local_displacements;
+		TArray<TArray<glm::vec2> > blend_post_displacements;
+		TArray<glm::vec4> blend_region_colors;
+		TMap<FName, TArray<glm::vec4> > blend_additive_ref_pts;
         
         std::function<void (TMap<FName, meshBone *>&) > bones_override_callback;
         
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CreatureWorldSubsystem.generated.h"
+
+class UCreatureMeshComponent;
+class UCreatureWorldSubsystem;
+
+/**
+* Tick function that runs the batched creature updates of a world
+**/
+USTRUCT()
+struct FCreatureBatchTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	UCreatureWorldSubsystem * Target;
+
+	virtual void ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCreatureBatchTickFunction> : public TStructOpsTypeTraitsBase2<FCreatureBatchTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+// Gathers the creature components that run multicore during the component ticks, then
+// evaluates all of them in one parallel batch and publishes their render data in one pass.
+// Also splits the animation LOD time budget between the components of the world.
+UCLASS()
+class CREATUREPLUGIN_API UCreatureWorldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Queues a component to be updated in this frame's batch
+	void QueueTick(UCreatureMeshComponent * component_in, float delta_time);
+
+	void RunBatch();
+
+	// Whether a component with the given flag uses animation LOD, creature.AnimLOD can override it
+	bool ShouldUseAnimationLOD(bool component_flag) const;
+
+	// Registers a component for this frame's budget pass, cost is its update ms per frame
+	void ReportAnimationLOD(UCreatureMeshComponent * component_in, float significance, float cost);
+
+	// Slows down the least significant components until the reported costs fit creature.AnimLODBudgetMs
+	void ArbitrateAnimationLOD();
+
+protected:
+	void RegisterBatchTick();
+
+	struct FQueuedTick
+	{
+		TWeakObjectPtr<UCreatureMeshComponent> component;
+		float delta_time;
+		int32 cost;
+		bool can_tick;
+	};
+
+	struct FLODReport
+	{
+		TWeakObjectPtr<UCreatureMeshComponent> component;
+		float significance;
+		float cost;
+	};
+
+	TArray<FQueuedTick> queued_ticks;
+	TArray<FLODReport> lod_reports;
+	FCreatureBatchTickFunction batch_tick_function;
+};
@@ -102,6 +102,9 @@ public:
     
     void fixDQs(const dualQuat& ref_dq);
     
+    // Flips this bone's dq into the same hemisphere as ref_dq, children are left alone
+    void fixDQ(const dualQuat& ref_dq);
+    
     void initWorldPts();
     
     glm::vec4 getWorldRestStartPt() const;
@@ -134,6 +137,9 @@ public:
     
     void computeWorldDeltaTransforms();
     
+    // Same as computeWorldDeltaTransforms() but only for this bone
+    void computeWorldDeltaTransform();
+    
     void addChild(meshBone * bone_in);
     
     TArray<meshBone *>& getChildren() {
@@ -152,6 +158,9 @@ public:
     
     TArray<meshBone *> getAllChildren();
     
+    // Returns a deep copy of this bone and all of its children
+    meshBone * cloneHierarchy() const;
+    
     int32 getBoneDepth(meshBone * bone_in, int32 depth=0) const;
     
     bool isLeaf() const {
@@ -196,6 +205,40 @@ protected:
 	meshBone * parent;
 };
 
+// A single bone influence on a vertex, bone_index points into the fast bones of the region
+struct meshBoneInfluence {
+    uint16 bone_index;
+    float weight;
+};
+
+// Skinning weights of a region, shared between all clones of the same creature
+struct meshRenderRegionWeights {
+    TMap<FName, TArray<float> > normal_weight_map;
+    TArray<FName> fast_bone_keys;
+    
+    // Fixed width influence table, max_influences entries per vertex ( strongest first )
+    // with the weights renormalized. influence_counts holds the used entries per vertex.
+    static const int32 max_influences = 8;
+    TArray<meshBoneInfluence> influences;
+    TArray<uint8> influence_counts;
+    
+    // Sorted indices into fast_bone_keys of the bones that influence at least one vertex of the region
+    TArray<uint16> influence_bone_indices;
+    
+    // Packed influences for the vectorized skinning path. Vertices are processed in groups of
+    // simd_lanes, each influence row holds one bone index and weight per vertex of the group.
+    static const int32 simd_lanes = 4;
+    TArray<int32> simd_group_offsets;
+    TArray<int32> simd_bone_indices;
+    TArray<float> simd_weights;
+    
+    // Vertices with identical influences share a cluster, its dq is blended once per pose.
+    // Left empty when too few vertices share influences for clustering to pay off.
+    TArray<meshBoneInfluence> cluster_influences;
+    TArray<uint8> cluster_influence_counts;
+    TArray<int32> pt_cluster_indices;
+};
+
 class meshRenderRegion {
 public:
     meshRenderRegion(glm::uint32 * indices_in,
@@ -208,14 +251,39 @@ public:
     
     virtual ~meshRenderRegion();
 
+    // Returns a copy of this region posed by the bones of root_bone_in, sharing its weights
+    meshRenderRegion * clone(glm::uint32 * indices_in,
+                             glm::float32 * rest_pts_in,
+                             glm::float32 * uvs_in,
+                             meshBone * root_bone_in,
+                             const TMap<FName, meshBone *>& bones_map) const;
+
     glm::uint32 * getIndices() const;
     
     glm::float32 * getRestPts() const;
     
     glm::float32 * getUVs() const;
     
+    // Dense weights per bone, only filled in while loading.
+    // initFastNormalWeightMap builds the influence table from them and then empties them.
     TMap<FName, TArray<float> >& getWeights();
     
+    // Writes the weight of bone_key on every point from the influence table, 0 where it has no influence
+    void fillBoneWeights(const FName& bone_key, float * weights_out) const;
+    
+    // The influence table, bone_index of every influence points into getInfluenceBoneKeys()
+    const TArray<FName>& getInfluenceBoneKeys() const;
+    
+    const TArray<meshBoneInfluence>& getInfluences() const;
+    
+    const TArray<uint8>& getInfluenceCounts() const;
+    
+    // Sets a prebuilt influence table instead of dense weights, influences_in holds max_influences
+    // entries per point. initFastNormalWeightMap then only looks up the bones.
+    void setInfluences(const TArray<FName>& bone_keys_in,
+                       TArray<meshBoneInfluence>&& influences_in,
+                       TArray<uint8>&& influence_counts_in);
+    
     void renameWeightValuesByKey(const FName& old_key,
                                  const FName& new_key);
     
@@ -234,6 +302,7 @@ public:
     void poseFinalPts(glm::float32 * output_pts,
                       TMap<FName, meshBone *>& bones_map);
     
+    // Skips skinning and writes last pose again when none of the inputs changed
     void poseFastFinalPts(glm::float32 * output_pts,
 						  bool try_local_displacements=true,
 						  bool try_post_displacements=true,
@@ -322,6 +391,27 @@ public:
 protected:
     
     void initUvWarp();
+    
+    void initSimdInfluences();
+    
+    void initInfluenceClusters();
+    
+    void initInfluenceBones();
+    
+    void blendClusterDqs();
+    
+    void poseFastFinalPtsScalar(glm::float32 * output_pts,
+                                bool try_local_displacements,
+                                bool try_post_displacements);
+    
+    void poseFastFinalPtsSimd(glm::float32 * output_pts,
+                              bool try_local_displacements,
+                              bool try_post_displacements);
+    
+    // Whether bones or displacements differ from the ones last posed with
+    bool isPoseDirty(bool add_local, bool add_post) const;
+    
+    void storePoseState(const glm::float32 * output_pts, bool add_local, bool add_post);
 
     int32 start_pt_index, end_pt_index;
     int32 start_index, end_index;
@@ -338,13 +428,18 @@ protected:
 	int32 uv_level;
 	float opacity;
 	float red, green, blue;
-    TMap<FName, TArray<float> > normal_weight_map;
+    TSharedPtr<meshRenderRegionWeights> weights_data;
 //    TMap<int32, TArray<float> > fast_normal_weight_map;
     TArray<TArray<float> > fast_normal_weight_map;
-    TArray<TArray<float> > reverse_fast_normal_weight_map;
     TArray<meshBone *> fast_bones_map;
-    TArray<TArray<int32> > relevant_bones_indices;
     TArray<dualQuat> fill_dq_array;
+    TArray<float> fill_dq_values;
+    TArray<dualQuat> cluster_dqs;
+    // Inputs and output of the last pose, for skipping unchanged regions
+    TArray<glm::float32> last_pose_pts;
+    TArray<dualQuat> last_pose_dqs;
+    TArray<glm::vec2> last_local_displacements, last_post_displacements;
+    bool last_pose_local, last_pose_post;
     FName main_bone_key;
     meshBone * main_bone;
     bool use_dq;
@@ -352,6 +447,8 @@ protected:
     int32 tag_id;
 };
 
+class meshBoneCacheManager;
+
 class meshRenderBoneComposition {
 public:
     meshRenderBoneComposition();
@@ -362,7 +459,7 @@ public:
     
     void setRootBone(meshBone * root_bone_in);
     
-    meshBone * getRootBone();
+    meshBone * getRootBone() const;
     
     void initBoneMap();
     
@@ -372,6 +469,21 @@ public:
     
     TMap<FName, meshBone *>& getBonesMap();
     
+    // Bones in a fixed slot order, parents always come before their children
+    TArray<meshBone *>& getBoneSlots();
+    
+    // Parent slot of each bone slot, -1 for the root
+    const TArray<int32>& getBoneParentSlots() const;
+    
+    // Maps bone keys to slots, shared between compositions with the same skeleton
+    const TSharedPtr<TMap<FName, int32> >& getBoneSlotLayout() const;
+    
+    void setBoneSlotLayout(const TSharedPtr<TMap<FName, int32> >& layout_in);
+    
+    // Bone slot of each flattened row of a bone cache, -1 for bones this composition does not have.
+    // Resolved once per cache and kept here, so posing never writes to the shared caches
+    const TArray<int32>& getCacheBoneSlots(const meshBoneCacheManager& cache_in);
+    
     TMap<FName, meshRenderRegion *>& getRegionsMap();
     
     TArray<meshRenderRegion *>& getRegions();
@@ -386,6 +498,10 @@ protected:
     
     meshBone * root_bone;
     TMap<FName, meshBone *> bones_map;
+    TArray<meshBone *> bone_slots;
+    TArray<int32> bone_parent_slots;
+    TSharedPtr<TMap<FName, int32> > bone_slot_layout;
+    TMap<uint32, TArray<int32> > cache_bone_slots;
     TArray<meshRenderRegion *> regions;
     TMap<FName, meshRenderRegion *> regions_map;
 };
@@ -577,6 +693,15 @@ protected:
 	float red, green, blue;
 };
 
+// One bone of a compressed bone cache. Only the keys needed to stay within the compression
+// tolerance are kept, as 16 bit values quantized against the bounds of the track.
+struct meshBoneCompressedTrack {
+    int32 first_key;            // into the key frames and values of the cache
+    int32 num_keys;             // 1 for a constant track
+    float bounds_min[4];        // start.xy, end.xy
+    float bounds_step[4];
+};
+
 class meshBoneCacheManager {
 public:
     meshBoneCacheManager();
@@ -586,7 +711,15 @@ public:
     bone_cache_data_ready( other.bone_cache_data_ready),
     start_time( other.start_time),
     end_time( other.end_time),
-    is_ready( other.is_ready)
+    is_ready( other.is_ready),
+    flat_bone_keys( other.flat_bone_keys),
+    flat_cache( other.flat_cache),
+    flat_keys_id( other.flat_keys_id),
+    key_frames( other.key_frames),
+    frame_keys( other.frame_keys),
+    compressed_tracks( other.compressed_tracks),
+    compressed_frames( other.compressed_frames),
+    compressed_values( other.compressed_values)
     {}
     
     meshBoneCacheManager& operator=( const meshBoneCacheManager& other ) {
@@ -595,6 +728,14 @@ public:
         start_time = other.start_time;
         end_time = other.end_time;
         is_ready = other.is_ready;
+        flat_bone_keys = other.flat_bone_keys;
+        flat_cache = other.flat_cache;
+        flat_keys_id = other.flat_keys_id;
+        key_frames = other.key_frames;
+        frame_keys = other.frame_keys;
+        compressed_tracks = other.compressed_tracks;
+        compressed_frames = other.compressed_frames;
+        compressed_values = other.compressed_values;
         
         return *this;
     }
@@ -615,24 +756,96 @@ public:
     void retrieveValuesAtTime(float time_in,
                               TMap<FName, meshBone *>& bone_map);
     
+    // Fast path, reads the flattened cache straight into the bone slots of the composition
+    void retrieveValuesAtTime(float time_in,
+                              meshRenderBoneComposition& composition);
+    
     std::pair<glm::vec4, glm::vec4> retrieveSingleBoneValueAtTime(const FName& key_in,
                                                                   float time_in);
     
     bool allReady();
     
+    // Marks all frames as ready, drops the frames without keys and flattens the cache table
     void makeAllReady();
     
+    // Per frame cache while filling in, only valid before makeAllReady() is called
     TArray<TArray<meshBoneCache> >& getCacheTable();
+    
+    // Bone keys of the flattened cache rows
+    const TArray<FName>& getFlatBoneKeys() const;
+    
+    // Unique id of the current flat bone keys, changes whenever they do
+    uint32 getFlatKeysId() const;
+    
+    // Flattened cache laid out as [key][bone][start.xy, end.xy]
+    const TArray<float>& getFlatCache() const;
+    
+    // Finds the stored keys around a time and the blend factor between them
+    bool getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const;
+    
+    // Frame offsets from the start time of the stored keys, valid after makeAllReady()
+    const TArray<int32>& getKeyFrames() const;
+    
+    // Lossy compresses the flattened cache, retrieved bone points stay within tolerance_in of
+    // the exported ones. Returns false and keeps the cache as is if it cannot be compressed.
+    bool compressTracks(float tolerance_in);
+    
+    // Sets up the cache from already compressed tracks, one per bone key
+    void setCompressedTracks(const TArray<FName>& bone_keys_in,
+                             const TArray<meshBoneCompressedTrack>& tracks_in,
+                             const TArray<uint16>& frames_in,
+                             const TArray<uint16>& values_in);
+    
+    bool isCompressed() const;
+    
+    const TArray<meshBoneCompressedTrack>& getCompressedTracks() const;
+    
+    // Frame offsets from the start time of the kept keys of all tracks
+    const TArray<uint16>& getCompressedFrames() const;
+    
+    // Quantized start.xy, end.xy of the kept keys of all tracks
+    const TArray<uint16>& getCompressedValues() const;
 
 protected:
+    void buildFlatCache();
+    
+    void setFlatBoneKeys(const TArray<FName>& keys_in);
+    
+    float getCompressedTime(float time_in) const;
+    
+    void decodeCompressedBone(int32 bone_index, float local_time, float * vals_out) const;
+    
     TArray<TArray<meshBoneCache> > bone_cache_table;
     TArray<bool> bone_cache_data_ready;
     int32 start_time, end_time;
     bool is_ready;
     
+    TArray<FName> flat_bone_keys;
+    TArray<float> flat_cache;
+    uint32 flat_keys_id;
+    
+    // Frame offset of each stored key, and the last key at or before each frame
+    TArray<int32> key_frames;
+    TArray<int32> frame_keys;
+    
+    TArray<meshBoneCompressedTrack> compressed_tracks;
+    TArray<uint16> compressed_frames;
+    TArray<uint16> compressed_values;
+    
     FCriticalSection data_lock;
 };
 
+// One region of a basis compressed displacement cache. Each key of the region is the mean shape
+// plus a weighted sum of num_basis shapes, shapes list the local displacements before the post ones.
+struct meshDisplacementBasisTrack {
+    FName key;
+    int32 num_local_pts;
+    int32 num_post_pts;
+    int32 num_basis;
+    int32 basis_offset;         // into the basis values, the mean shape then the basis shapes
+    int32 coeffs_offset;        // into the basis coefficients, num_basis per key
+};
+
 class meshDisplacementCacheManager {
 public:
     meshDisplacementCacheManager();
@@ -642,7 +855,12 @@ public:
     displacement_cache_data_ready( other.displacement_cache_data_ready),
     start_time( other.start_time),
     end_time( other.end_time),
-    is_ready( other.is_ready)
+    is_ready( other.is_ready),
+    key_frames( other.key_frames),
+    frame_keys( other.frame_keys),
+    basis_tracks( other.basis_tracks),
+    basis_values( other.basis_values),
+    basis_coeffs( other.basis_coeffs)
     {}
     
     meshDisplacementCacheManager& operator=( const meshDisplacementCacheManager& other ) {
@@ -651,6 +869,11 @@ public:
         start_time = other.start_time;
         end_time = other.end_time;
         is_ready = other.is_ready;
+        key_frames = other.key_frames;
+        frame_keys = other.frame_keys;
+        basis_tracks = other.basis_tracks;
+        basis_values = other.basis_values;
+        basis_coeffs = other.basis_coeffs;
         
         return *this;
     }
@@ -687,15 +910,61 @@ public:
 
     bool allReady();
     
+    // Marks all frames as ready and drops the frames without keys
     void makeAllReady();
 
+    // Per frame cache while filling in, one row per stored key after makeAllReady()
     TArray<TArray<meshDisplacementCache> >& getCacheTable();
     
+    // Finds the stored keys around a time and the blend factor between them
+    bool getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const;
+    
+    // Frame offsets from the start time of the stored keys, valid after makeAllReady()
+    const TArray<int32>& getKeyFrames() const;
+    
+    // Whether a region of the first key has local and post displacements, by region index
+    void getDisplacementUsage(int32 region_index, bool& use_local_out, bool& use_post_out) const;
+    
+    // Factors the displacements of each region into basis shapes plus per key coefficients,
+    // retrieved points stay within tolerance_in of the exported ones.
+    // Returns false and keeps the cache as is if it cannot be compressed.
+    bool compressTracks(float tolerance_in);
+    
+    // Sets up the cache from already compressed tracks, call init() first
+    void setBasisTracks(const TArray<int32>& key_frames_in,
+                        const TArray<meshDisplacementBasisTrack>& tracks_in,
+                        const TArray<float>& values_in,
+                        const TArray<float>& coeffs_in);
+    
+    bool isCompressed() const;
+    
+    const TArray<meshDisplacementBasisTrack>& getBasisTracks() const;
+    
+    const TArray<float>& getBasisValues() const;
+    
+    const TArray<float>& getBasisCoeffs() const;
+    
 protected:
+    int32 findBasisTrack(const FName& key_in) const;
+    
+    // Reconstructs the local and post displacements of a track blended between two keys, either output can be NULL
+    void decodeBasisTrack(const meshDisplacementBasisTrack& track_in,
+                          int32 base_key,
+                          int32 end_key,
+                          float ratio,
+                          float * local_out,
+                          float * post_out) const;
+    
     TArray<TArray<meshDisplacementCache> > displacement_cache_table;
     TArray<bool> displacement_cache_data_ready;
     int32 start_time, end_time;
     bool is_ready;
+    TArray<int32> key_frames;
+    TArray<int32> frame_keys;
+    
+    TArray<meshDisplacementBasisTrack> basis_tracks;
+    TArray<float> basis_values;
+    TArray<float> basis_coeffs;
     
 	FCriticalSection data_lock;
 };
@@ -709,7 +978,9 @@ public:
     uv_cache_data_ready( other.uv_cache_data_ready),
     start_time( other.start_time),
     end_time( other.end_time),
-    is_ready( other.is_ready)
+    is_ready( other.is_ready),
+    key_frames( other.key_frames),
+    frame_keys( other.frame_keys)
     {}
     
     meshUVWarpCacheManager& operator=( const meshUVWarpCacheManager& other ) {
@@ -718,6 +989,8 @@ public:
         start_time = other.start_time;
         end_time = other.end_time;
         is_ready = other.is_ready;
+        key_frames = other.key_frames;
+        frame_keys = other.frame_keys;
         
         return *this;
     }
@@ -746,15 +1019,25 @@ public:
     
     bool allReady();
     
+    // Marks all frames as ready and drops the frames without keys
     void makeAllReady();
 
+    // Per frame cache while filling in, one row per stored key after makeAllReady()
     TArray<TArray<meshUVWarpCache> >& getCacheTable();
+    
+    // Finds the stored keys around a time and the blend factor between them
+    bool getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const;
+    
+    // Frame offsets from the start time of the stored keys, valid after makeAllReady()
+    const TArray<int32>& getKeyFrames() const;
 
 protected:
     TArray<TArray<meshUVWarpCache> > uv_cache_table;
     TArray<bool> uv_cache_data_ready;
     int32 start_time, end_time;
     bool is_ready;
+    TArray<int32> key_frames;
+    TArray<int32> frame_keys;
     
 	FCriticalSection data_lock;
 };
@@ -768,7 +1051,9 @@ public:
 		opacity_cache_data_ready(other.opacity_cache_data_ready),
 		start_time(other.start_time),
 		end_time(other.end_time),
-		is_ready(other.is_ready)
+		is_ready(other.is_ready),
+		key_frames(other.key_frames),
+		frame_keys(other.frame_keys)
 	{}
 
 	meshOpacityCacheManager& operator=(const meshOpacityCacheManager& other) {
@@ -777,6 +1062,8 @@ public:
 		start_time = other.start_time;
 		end_time = other.end_time;
 		is_ready = other.is_ready;
+		key_frames = other.key_frames;
+		frame_keys = other.frame_keys;
 
 		return *this;
 	}
@@ -803,15 +1090,29 @@ public:
 
 	bool allReady();
 
+	// Marks all frames as ready and drops the frames without keys
 	void makeAllReady();
 
+	// Per frame cache while filling in, one row per stored key after makeAllReady()
 	TArray<TArray<meshOpacityCache> >& getCacheTable();
 
+	// Finds the stored keys around a time and the blend factor between them
+	bool getKeysAtTime(float time_in, int32& base_key, int32& end_key, float& ratio) const;
+
+	// Frame offsets from the start time of the stored keys, valid after makeAllReady()
+	const TArray<int32>& getKeyFrames() const;
+
+	// Adds keys at the given frame offsets, blended from the stored keys around them.
+	// Frames that already have a key keep it, valid after makeAllReady()
+	void insertKeys(const TArray<int32>& frames_in);
+
 protected:
 	TArray<TArray<meshOpacityCache> > opacity_cache_table;
 	TArray<bool> opacity_cache_data_ready;
 	int32 start_time, end_time;
 	bool is_ready;
+	TArray<int32> key_frames;
+	TArray<int32> frame_keys;
 
 	FCriticalSection data_lock;
 };